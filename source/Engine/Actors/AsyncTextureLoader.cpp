@@ -0,0 +1,269 @@
+//
+// Created by Shaun on 17/10/2026.
+//
+
+#include "AsyncTextureLoader.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "stb_image.h"
+#include "Logger.h"
+#include "Texture.h"
+
+AsyncTextureLoader::AsyncTextureLoader(size_t workerCount, size_t maxDecodedImages)
+    : m_decoded(maxDecodedImages)
+{
+    for (auto& pixelBuffer : m_pixelBuffers) {
+        glGenBuffers(1, &pixelBuffer.buffer);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffer.buffer);
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, kPixelBufferSize, nullptr, GL_STREAM_DRAW);
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    workerCount = std::max<size_t>(workerCount, 1);
+    for (size_t i = 0; i < workerCount; i++) {
+        m_workers.emplace_back(&AsyncTextureLoader::workerLoop, this);
+    }
+}
+
+AsyncTextureLoader::~AsyncTextureLoader()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_requestMutex);
+        m_stopping = true;
+    }
+    m_requestCondition.notify_all();
+    // unblocks any worker stuck pushing into a full queue
+    m_decoded.close();
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+
+    if (m_hasCurrentUpload) {
+        glDeleteTextures(1, &m_currentTexture);
+    }
+    for (auto& pixelBuffer : m_pixelBuffers) {
+        if (pixelBuffer.fence) {
+            glDeleteSync(pixelBuffer.fence);
+        }
+        glDeleteBuffers(1, &pixelBuffer.buffer);
+    }
+}
+
+void AsyncTextureLoader::request(const std::string& filePath, GLuint placeholderID, const std::string& loadPath,
+                                 int startMipSize)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_requestMutex);
+        m_requests.push_back({filePath, placeholderID, loadPath, startMipSize});
+    }
+    m_requestCondition.notify_one();
+}
+
+bool AsyncTextureLoader::hasPendingWork() const
+{
+    std::lock_guard<std::mutex> lock(m_requestMutex);
+    return !m_requests.empty() || m_decoding > 0 || m_decoded.size() > 0 || m_hasCurrentUpload;
+}
+
+void AsyncTextureLoader::workerLoop()
+{
+    while (true) {
+        DecodeRequest request;
+        {
+            std::unique_lock<std::mutex> lock(m_requestMutex);
+            m_requestCondition.wait(lock, [this]() { return m_stopping || !m_requests.empty(); });
+            if (m_stopping)
+                return;
+            request = std::move(m_requests.front());
+            m_requests.pop_front();
+            m_decoding++;
+        }
+
+        DecodedImage image;
+        image.filePath = request.filePath;
+        image.placeholderID = request.placeholderID;
+
+        if (KtxFile::isKtxPath(request.loadPath)) {
+            // baked: already compressed and mipped, mapping the file is all the work there is
+            auto compressed = std::make_shared<KtxFile>();
+            if (compressed->open(request.loadPath)) {
+                image.width = compressed->getWidth();
+                image.height = compressed->getHeight();
+                image.baseLevel = Texture::getStartLevel(*compressed, request.startMipSize);
+                image.compressed = std::move(compressed);
+            } else {
+                LOG_ERROR(Texture, "Failed to load baked texture: " << request.loadPath);
+            }
+        } else {
+            // grey and grey+alpha images are expanded so the upload only has to deal with RGB/RGBA
+            int fileChannels = 0;
+            int desiredChannels = 0;
+            if (stbi_info(request.filePath.c_str(), &image.width, &image.height, &fileChannels)) {
+                desiredChannels = (fileChannels == 2 || fileChannels == 4) ? 4 : 3;
+            }
+            unsigned char* pixels = desiredChannels != 0
+                ? stbi_load(request.filePath.c_str(), &image.width, &image.height, &fileChannels, desiredChannels)
+                : nullptr;
+
+            if (pixels) {
+                image.channels = desiredChannels;
+                image.pixels = std::unique_ptr<unsigned char, void (*)(void*)>(pixels, stbi_image_free);
+            } else {
+                LOG_ERROR(Texture, "Failed to load texture: " << request.filePath);
+            }
+        }
+
+        // failed decodes still go through the queue so the placeholder gets released on the GL thread
+        bool queued = m_decoded.push(std::move(image));
+
+        std::lock_guard<std::mutex> lock(m_requestMutex);
+        m_decoding--;
+        if (!queued)
+            return;
+    }
+}
+
+void AsyncTextureLoader::beginUpload(DecodedImage image)
+{
+    m_currentUpload = std::move(image);
+    m_hasCurrentUpload = true;
+    m_rowsUploaded = 0;
+    m_levelUploading = static_cast<size_t>(m_currentUpload.baseLevel);
+
+    glGenTextures(1, &m_currentTexture);
+    glBindTexture(GL_TEXTURE_2D, m_currentTexture);
+    Texture::setDefaultParameters(GL_TEXTURE_2D);
+
+    if (m_currentUpload.compressed) {
+        // allocate the chain from the start level down now, processUploads() fills it in level by level
+        const KtxFile& ktx = *m_currentUpload.compressed;
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, m_currentUpload.baseLevel);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(ktx.getLevels().size() - 1));
+        for (size_t i = m_currentUpload.baseLevel; i < ktx.getLevels().size(); i++) {
+            const KtxFile::Level& level = ktx.getLevels()[i];
+            glCompressedTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(i), ktx.getInternalFormat(), level.width,
+                                   level.height, 0, static_cast<GLsizei>(level.size), nullptr);
+        }
+        return;
+    }
+
+    GLenum format = (m_currentUpload.channels == 4) ? GL_RGBA : GL_RGB;
+    glTexImage2D(GL_TEXTURE_2D, 0, format, m_currentUpload.width, m_currentUpload.height, 0, format, GL_UNSIGNED_BYTE, nullptr);
+}
+
+void AsyncTextureLoader::uploadRows(int y, int height, const void* data, size_t bytes)
+{
+    if (m_currentUpload.compressed) {
+        const KtxFile& ktx = *m_currentUpload.compressed;
+        const KtxFile::Level& level = ktx.getLevels()[m_levelUploading];
+        glCompressedTexSubImage2D(GL_TEXTURE_2D, static_cast<GLint>(m_levelUploading), 0, y, level.width, height,
+                                  ktx.getInternalFormat(), static_cast<GLsizei>(bytes), data);
+        return;
+    }
+
+    GLenum format = (m_currentUpload.channels == 4) ? GL_RGBA : GL_RGB;
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, y, m_currentUpload.width, height, format, GL_UNSIGNED_BYTE, data);
+}
+
+void AsyncTextureLoader::processUploads(size_t byteBudget, std::vector<TextureUpload>& completed)
+{
+    bool boundTexture = false;
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // RGB rows are not 4 byte aligned
+
+    while (byteBudget > 0) {
+        if (!m_hasCurrentUpload) {
+            DecodedImage image;
+            if (!m_decoded.tryPop(image))
+                break;
+
+            if (!image.pixels && !image.compressed) {
+                // report the failure so the placeholder is swapped for "no texture"
+                completed.push_back({image.filePath, image.placeholderID, 0});
+                continue;
+            }
+            beginUpload(std::move(image));
+        } else if (!boundTexture) {
+            glBindTexture(GL_TEXTURE_2D, m_currentTexture);
+        }
+        boundTexture = true;
+
+        PixelBuffer& pixelBuffer = m_pixelBuffers[m_nextPixelBuffer];
+        if (pixelBuffer.fence) {
+            // never stall the frame: if the GPU hasn't consumed this buffer yet, try again next frame
+            if (glClientWaitSync(pixelBuffer.fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+                break;
+            glDeleteSync(pixelBuffer.fence);
+            pixelBuffer.fence = nullptr;
+        }
+
+        // a "row" is one texel row of a plain image, or one row of 4x4 blocks of a baked level
+        const unsigned char* source = m_currentUpload.pixels.get();
+        int levelHeight = m_currentUpload.height;
+        int rowHeight = 1;
+        size_t rowBytes = static_cast<size_t>(m_currentUpload.width) * m_currentUpload.channels;
+        if (m_currentUpload.compressed) {
+            const KtxFile::Level& level = m_currentUpload.compressed->getLevels()[m_levelUploading];
+            source = level.data;
+            levelHeight = level.height;
+            rowHeight = 4;
+            rowBytes = level.size / ((level.height + 3) / 4);
+        }
+
+        const int firstRow = m_rowsUploaded / rowHeight;
+        const int totalRows = (levelHeight + rowHeight - 1) / rowHeight;
+        const size_t maxRowsPerBuffer = std::max<size_t>(kPixelBufferSize / rowBytes, 1);
+        const size_t budgetRows = std::max<size_t>(byteBudget / rowBytes, 1);
+        const int rows = static_cast<int>(std::min({maxRowsPerBuffer, budgetRows, static_cast<size_t>(totalRows - firstRow)}));
+        const size_t uploadBytes = rows * rowBytes;
+        const int uploadHeight = std::min(rows * rowHeight, levelHeight - m_rowsUploaded);
+        const unsigned char* sliceData = source + firstRow * rowBytes;
+
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffer.buffer);
+        if (uploadBytes > kPixelBufferSize) {
+            // single row wider than the ring buffer (> 1M RGBA texels), grow this buffer
+            glBufferData(GL_PIXEL_UNPACK_BUFFER, uploadBytes, nullptr, GL_STREAM_DRAW);
+        }
+        void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, uploadBytes,
+                                        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+        if (mapped) {
+            std::memcpy(mapped, sliceData, uploadBytes);
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+            uploadRows(m_rowsUploaded, uploadHeight, nullptr, uploadBytes);
+            pixelBuffer.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        } else {
+            // mapping failed, fall back to a client memory upload for this slice
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            uploadRows(m_rowsUploaded, uploadHeight, sliceData, uploadBytes);
+        }
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        m_nextPixelBuffer = (m_nextPixelBuffer + 1) % kPixelBufferCount;
+        m_rowsUploaded += uploadHeight;
+        byteBudget = uploadBytes < byteBudget ? byteBudget - uploadBytes : 0;
+
+        if (m_rowsUploaded == levelHeight) {
+            if (m_currentUpload.compressed && m_levelUploading + 1 < m_currentUpload.compressed->getLevels().size()) {
+                m_levelUploading++;
+                m_rowsUploaded = 0;
+                continue;
+            }
+
+            // baked textures brought their own mips
+            if (!m_currentUpload.compressed)
+                glGenerateMipmap(GL_TEXTURE_2D);
+            completed.push_back({m_currentUpload.filePath, m_currentUpload.placeholderID, m_currentTexture,
+                                 m_currentUpload.width, m_currentUpload.height, m_currentUpload.channels,
+                                 m_currentUpload.compressed, m_currentUpload.baseLevel});
+            m_currentUpload = DecodedImage();
+            m_hasCurrentUpload = false;
+            m_currentTexture = 0;
+            boundTexture = false;
+        }
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
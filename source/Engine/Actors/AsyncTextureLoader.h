@@ -0,0 +1,112 @@
+//
+// Created by Shaun on 17/10/2026.
+//
+
+#ifndef ASYNCTEXTURELOADER_H
+#define ASYNCTEXTURELOADER_H
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <GL/glew.h>
+
+#include "BoundedQueue.h"
+#include "KtxFile.h"
+
+// A texture whose upload finished this frame. placeholderID is what the materials currently reference.
+struct TextureUpload {
+    std::string filePath;
+    GLuint placeholderID = 0;
+    GLuint textureID = 0;
+
+    // what was uploaded, for the TextureManager's residency accounting
+    int width = 0;
+    int height = 0;
+    int channels = 0;                      // 0 for baked textures
+    std::shared_ptr<KtxFile> bakedFile;    // set for baked textures
+    int baseLevel = 0;                     // first level uploaded from bakedFile
+};
+
+/**
+ * @brief Decodes image files on worker threads and streams them to the GPU through a PBO ring.
+ *
+ * Workers pull file paths, decode them with stb and hand the pixels to the GL thread through a bounded
+ * queue (so at most a handful of decoded 4K images sit in memory at once). Baked .ktx files skip the
+ * decode: the worker only maps and validates them, and their levels are streamed block row by block row
+ * with glCompressedTexSubImage2D instead of generating mips on the GPU. processUploads() must be
+ * called on the GL thread; it copies at most the given number of bytes per call into persistent pixel
+ * unpack buffers and never waits on the GPU - a PBO still in flight simply ends that frame's uploads.
+ */
+class AsyncTextureLoader {
+public:
+    AsyncTextureLoader(size_t workerCount, size_t maxDecodedImages);
+    ~AsyncTextureLoader();
+
+    AsyncTextureLoader(const AsyncTextureLoader&) = delete;
+    AsyncTextureLoader& operator=(const AsyncTextureLoader&) = delete;
+
+    // loadPath is what actually gets read (the baked .ktx or the source), filePath is reported back on completion.
+    // Baked files only get their levels at most startMipSize big uploaded (0 = all of them).
+    void request(const std::string& filePath, GLuint placeholderID, const std::string& loadPath, int startMipSize = 0);
+
+    // GL thread only. Appends every texture that finished uploading to completed.
+    void processUploads(size_t byteBudget, std::vector<TextureUpload>& completed);
+
+    [[nodiscard]] bool hasPendingWork() const;
+
+private:
+    struct DecodeRequest {
+        std::string filePath;
+        GLuint placeholderID = 0;
+        std::string loadPath;
+        int startMipSize = 0;
+    };
+
+    struct DecodedImage {
+        std::string filePath;
+        GLuint placeholderID = 0;
+        int width = 0;
+        int height = 0;
+        int channels = 0;
+        std::unique_ptr<unsigned char, void (*)(void*)> pixels{nullptr, nullptr};
+        std::shared_ptr<KtxFile> compressed; // set instead of pixels for baked textures
+        int baseLevel = 0;                   // first level of compressed to upload
+    };
+
+    struct PixelBuffer {
+        GLuint buffer = 0;
+        GLsync fence = nullptr;
+    };
+
+    static constexpr size_t kPixelBufferCount = 3;
+    static constexpr size_t kPixelBufferSize = 4 * 1024 * 1024;
+
+    void workerLoop();
+    void beginUpload(DecodedImage image);
+    void uploadRows(int y, int height, const void* data, size_t bytes);
+
+    // worker side
+    std::vector<std::thread> m_workers;
+    std::deque<DecodeRequest> m_requests;
+    mutable std::mutex m_requestMutex;
+    std::condition_variable m_requestCondition;
+    bool m_stopping = false;
+    size_t m_decoding = 0;
+
+    BoundedQueue<DecodedImage> m_decoded;
+
+    // GL thread side
+    PixelBuffer m_pixelBuffers[kPixelBufferCount];
+    size_t m_nextPixelBuffer = 0;
+    bool m_hasCurrentUpload = false;
+    DecodedImage m_currentUpload;
+    GLuint m_currentTexture = 0;
+    int m_rowsUploaded = 0;  // texel rows of m_levelUploading
+    size_t m_levelUploading = 0;
+};
+
+#endif //ASYNCTEXTURELOADER_H
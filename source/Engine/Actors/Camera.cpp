@@ -84,6 +84,16 @@ void Camera::addToPosition(const glm::vec3& offsetPosition)
     m_position += offsetPosition;
 }
 
+void Camera::lookAt(const glm::vec3& target)
+{
+    glm::vec3 direction = glm::normalize(target - m_position);
+    m_pitch = glm::degrees(asin(glm::clamp(direction.y, -1.0f, 1.0f)));
+    if (m_pitch > 89.0f) m_pitch = 89.0f;
+    if (m_pitch < -89.0f) m_pitch = -89.0f;
+    m_yaw = glm::degrees(atan2(direction.z, direction.x));
+    updateCameraVectors();
+}
+
 void Camera::updateCameraVectors()
 {
     glm::vec3 front;
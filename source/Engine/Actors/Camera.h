@@ -115,6 +115,13 @@ public:
      */
     void addToPosition(const glm::vec3& offsetPosition);
 
+    /**
+     * @brief Points the camera at a world position by recomputing yaw and pitch.
+     *
+     * @param target The point to look at.
+     */
+    void lookAt(const glm::vec3& target);
+
     const float getMovementSpeed() const {return m_speed;}
 
     const glm::vec3& getVelocity() const { return m_cameraVelocity; }
@@ -127,6 +134,10 @@ public:
     void setGrounded(bool grounded) { m_isCameraGrounded = grounded; }
 
     void setFOV(float fov) { m_fov = fov; }
+    float getFOV() const { return m_fov; }
+    float getAspectRatio() const { return m_aspectRatio; }
+    float getNearPlane() const { return m_nearPlane; }
+    float getFarPlane() const { return m_farPlane; }
 
     void setSpeed(float speed) { m_speed = speed; }
 
@@ -0,0 +1,77 @@
+//
+// Created by Shaun on 17/10/2026.
+//
+
+#include "CameraPath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+#include "Camera.h"
+#include "Logger.h"
+
+bool CameraPath::loadFromFile(const std::string& filePath)
+{
+    std::ifstream file(filePath);
+    if (!file.is_open()) {
+        LOG_ERROR(Scene, "CameraPath: failed to open " << filePath);
+        return false;
+    }
+
+    std::vector<CameraKeyframe> keyframes;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#')
+            continue;
+
+        std::istringstream stream(line);
+        CameraKeyframe keyframe{};
+        if (!(stream >> keyframe.position.x >> keyframe.position.y >> keyframe.position.z
+                     >> keyframe.target.x >> keyframe.target.y >> keyframe.target.z)) {
+            LOG_ERROR(Scene, "CameraPath: " << filePath << ":" << lineNumber << " expected \"px py pz tx ty tz\"");
+            return false;
+        }
+        keyframes.push_back(keyframe);
+    }
+
+    if (keyframes.empty()) {
+        LOG_ERROR(Scene, "CameraPath: " << filePath << " has no keyframes");
+        return false;
+    }
+    m_keyframes = std::move(keyframes);
+    return true;
+}
+
+CameraPath CameraPath::makeOrbit(const glm::vec3& center, float radius, float height, unsigned int keyframeCount)
+{
+    CameraPath path;
+    keyframeCount = std::max(keyframeCount, 2u);
+    for (unsigned int i = 0; i < keyframeCount; i++) {
+        float angle = 2.0f * 3.14159265f * static_cast<float>(i) / static_cast<float>(keyframeCount - 1);
+        glm::vec3 position = center + glm::vec3(std::cos(angle) * radius, height, std::sin(angle) * radius);
+        path.addKeyframe(position, center);
+    }
+    return path;
+}
+
+void CameraPath::apply(Camera& camera, float t) const
+{
+    if (m_keyframes.empty())
+        return;
+
+    t = std::min(std::max(t, 0.0f), 1.0f);
+    float segment = t * static_cast<float>(m_keyframes.size() - 1);
+    size_t index = std::min(static_cast<size_t>(segment), m_keyframes.size() - 1);
+    size_t next = std::min(index + 1, m_keyframes.size() - 1);
+    float blend = segment - static_cast<float>(index);
+
+    const CameraKeyframe& a = m_keyframes[index];
+    const CameraKeyframe& b = m_keyframes[next];
+    camera.setPosition(glm::mix(a.position, b.position, blend));
+    camera.lookAt(glm::mix(a.target, b.target, blend));
+}
@@ -0,0 +1,46 @@
+//
+// Created by Shaun on 17/10/2026.
+//
+
+#ifndef CAMERAPATH_H
+#define CAMERAPATH_H
+
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+class Camera;
+
+struct CameraKeyframe
+{
+    glm::vec3 position;
+    glm::vec3 target;
+};
+
+/**
+ * @brief Scripted camera fly-through used by the headless benchmark.
+ *
+ * Keyframes are spaced evenly over t = [0, 1] and linearly interpolated, so the same path and frame
+ * count always produce the same views. Path files have one keyframe per line,
+ * "px py pz tx ty tz", blank lines and lines starting with '#' are ignored.
+ */
+class CameraPath
+{
+public:
+    bool loadFromFile(const std::string& filePath);
+
+    // Circles centre at the given radius and height, looking at the centre
+    static CameraPath makeOrbit(const glm::vec3& center, float radius, float height, unsigned int keyframeCount);
+
+    void addKeyframe(const glm::vec3& position, const glm::vec3& target) { m_keyframes.push_back({position, target}); }
+
+    // Moves and orients the camera to point t (clamped to [0, 1]) along the path
+    void apply(Camera& camera, float t) const;
+
+    [[nodiscard]] size_t size() const { return m_keyframes.size(); }
+
+private:
+    std::vector<CameraKeyframe> m_keyframes;
+};
+
+#endif //CAMERAPATH_H
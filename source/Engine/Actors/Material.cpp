@@ -13,9 +13,9 @@
  */
 
 #include "Material.h"
+#include "Logger.h"
 #include <fstream>
 #include <sstream>
-#include <iostream>
 #include <glm/gtc/type_ptr.hpp>
 
 /**
@@ -53,7 +53,7 @@ Material Material::loadFromMTL(const std::string& mtlFile) {
     Material material; // Starts with default values
 
     if (!file.is_open()) {
-        std::cerr << "Failed to open MTL file: " << mtlFile << std::endl;
+        LOG_ERROR(Import, "Failed to open MTL file: " << mtlFile);
         return material; // Return default material if file can't be opened
     }
 
@@ -36,6 +36,14 @@ struct RawMaterialData {
     GLuint roughnessTextureID = 0; // Roughness texture
     GLuint normalTextureID = 0;    // Normal map
     bool isDecal = false;          // Decal flag
+    bool alphaTested = false;      // Cutout, discard where the albedo alpha is below 0.5
+
+    // Resolved source paths for the textures above, kept so the mesh cache can re-resolve the IDs
+    // without Assimp. Embedded textures are stored as "*<index>" like Assimp reports them.
+    std::string baseColorTexturePath;
+    std::string metalnessTexturePath;
+    std::string roughnessTexturePath;
+    std::string normalTexturePath;
 };
 
 
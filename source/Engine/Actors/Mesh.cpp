@@ -10,15 +10,24 @@
 #include "Mesh.h"
 #include "Material.h"
 
-#include <iostream>
-#include <fstream>
-#include <map>
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <iterator>
 #include <sstream>
 #include <stdexcept>
+#include <thread>
 #include <unordered_map>
 #include <glm/ext/matrix_transform.hpp>
 
 #include "chrono"
+#include "Logger.h"
+#include "MappedFile.h"
+#include "ThreadPool.h"
 
  /**
   * @brief Constructs
@@ -41,38 +50,172 @@ bool Mesh::init(const std::string& filename) {
         // setupMesh();
         return true;
     } else {
-        std::cerr << "Failed to load OBJ file: " << filename << std::endl;
+        LOG_ERROR(Mesh, "Failed to load OBJ file: " << filename);
         return false;
     }
 }
 
-void Mesh::generateInterleavedData()
+namespace
+{
+    /*
+     * Open addressing (linear probing) map from a small fixed-size integer key to the index of the
+     * vertex it was first seen with. Keys are stored inline with their index so a lookup that hits
+     * touches a single cache line, and finding and inserting is the same single probe sequence.
+     */
+    template <size_t N, typename Hash>
+    class VertexKeyTable
+    {
+    public:
+        using Key = std::array<int32_t, N>;
+
+        explicit VertexKeyTable(size_t expectedKeys) { resize(expectedKeys * 2); }
+
+        // The index of key, added as the next index when it hasn't been seen yet
+        uint32_t findOrInsert(const Key& key, bool& inserted)
+        {
+            uint32_t slot = Hash()(key) & m_mask;
+            for (;; slot = (slot + 1) & m_mask) {
+                const Slot& entry = m_slots[slot];
+                if (entry.index == kEmpty)
+                    break;
+                if (entry.key == key) {
+                    inserted = false;
+                    return entry.index;
+                }
+            }
+
+            const auto index = static_cast<uint32_t>(m_count++);
+            m_slots[slot] = {key, index};
+            inserted = true;
+
+            // keep the load factor at or below a half
+            if (m_count * 2 > m_slots.size())
+                resize(m_slots.size() * 2);
+            return index;
+        }
+
+    private:
+        static constexpr uint32_t kEmpty = 0xFFFFFFFFu;
+
+        struct Slot
+        {
+            Key key;
+            uint32_t index;
+        };
+
+        void resize(size_t minimumSlots)
+        {
+            size_t capacity = 16;
+            while (capacity < minimumSlots)
+                capacity *= 2;
+
+            std::vector<Slot> old(capacity, Slot{Key{}, kEmpty});
+            old.swap(m_slots);
+            m_mask = static_cast<uint32_t>(capacity - 1);
+            for (const Slot& entry : old) {
+                if (entry.index == kEmpty)
+                    continue;
+                uint32_t slot = Hash()(entry.key) & m_mask;
+                while (m_slots[slot].index != kEmpty)
+                    slot = (slot + 1) & m_mask;
+                m_slots[slot] = entry;
+            }
+        }
+
+        std::vector<Slot> m_slots;
+        size_t m_count = 0;
+        uint32_t m_mask = 0;
+    };
+
+    /*
+     * Every value in the key is mixed in and the finalizer spreads them over all 32 bits, so the
+     * v/vt/vn triples that share a position (hard edges, per-face normals) land anywhere in the table
+     * instead of all probing from the same home slot.
+     */
+    template <size_t N>
+    struct MixHash
+    {
+        uint32_t operator()(const std::array<int32_t, N>& key) const
+        {
+            uint64_t hash = 0x9E3779B97F4A7C15ull;
+            for (int32_t value : key)
+                hash = (hash ^ static_cast<uint32_t>(value)) * 0xFF51AFD7ED558CCDull;
+            hash ^= hash >> 33;
+            hash *= 0xC4CEB9FE1A85EC53ull;
+            return static_cast<uint32_t>(hash ^ (hash >> 33));
+        }
+    };
+
+    inline int32_t quantize(float value, float step)
+    {
+        return static_cast<int32_t>(std::lround(value / step));
+    }
+}
+
+void Mesh::generateInterleavedData(bool weld)
 {
     // Clear existing interleaved data to avoid duplication
     m_interleavedVertices.clear();
     m_interleavedIndices.clear();
+    m_interleavedIndices.reserve(faces.size() * 3);
+    m_interleavedVertices.reserve(vertices.size());
 
-    // Map to track unique vertices and assign them an index
-    std::map<VertexData, unsigned int> uniqueVertices;
-
-    for (const auto& face : faces) {
-        for (size_t i = 0; i < face.vertexIndices.size(); ++i) {
-            VertexData vertex;
-            vertex.Position = vertices[face.vertexIndices[i]];
+    auto makeVertex = [this](const Face& face, size_t i) {
+        VertexData vertex{};
+        vertex.Position = vertices[face.vertexIndices[i]];
+        if (face.normalIndices[i] >= 0) {
             vertex.Normal = glm::vec3(normals[face.normalIndices[i]].nx,
                                       normals[face.normalIndices[i]].ny,
                                       normals[face.normalIndices[i]].nz);
+        }
+        if (face.texCoordIndices[i] >= 0) {
             vertex.TexCoords = glm::vec2(texCoords[face.texCoordIndices[i]].u,
                                         texCoords[face.texCoordIndices[i]].v);
-
-            // Check if the vertex is already in the map
-            if (uniqueVertices.find(vertex) == uniqueVertices.end()) {
-                uniqueVertices[vertex] = static_cast<unsigned int>(m_interleavedVertices.size());
-                m_interleavedVertices.push_back(vertex);
+        }
+        return vertex;
+    };
+
+    if (!weld) {
+        // corners that reference the same v/vt/vn triple are the same vertex
+        VertexKeyTable<3, MixHash<3>> uniqueVertices(vertices.size());
+        for (const auto& face : faces) {
+            for (size_t i = 0; i < 3; ++i) {
+                bool inserted = false;
+                const uint32_t index = uniqueVertices.findOrInsert(
+                    {face.vertexIndices[i], face.texCoordIndices[i], face.normalIndices[i]}, inserted);
+                if (inserted)
+                    m_interleavedVertices.push_back(makeVertex(face, i));
+
+                // Add the index of the vertex to the index buffer
+                m_interleavedIndices.push_back(index);
+            }
+        }
+    } else {
+        // corners whose attributes land in the same quantization cell are the same vertex, even when the
+        // file stored them as separate elements; the first corner seen keeps its exact values
+        float extent = 1e-6f;
+        for (int axis = 0; axis < 3 && !vertices.empty(); ++axis) {
+            const auto [minimum, maximum] = std::minmax_element(vertices.begin(), vertices.end(),
+                [axis](const glm::vec3& a, const glm::vec3& b) { return a[axis] < b[axis]; });
+            extent = std::max(extent, (*maximum)[axis] - (*minimum)[axis]);
+        }
+        const float positionStep = extent * kWeldPositionStep;
+
+        VertexKeyTable<8, MixHash<8>> uniqueVertices(vertices.size());
+        for (const auto& face : faces) {
+            for (size_t i = 0; i < 3; ++i) {
+                const VertexData vertex = makeVertex(face, i);
+                bool inserted = false;
+                const uint32_t index = uniqueVertices.findOrInsert(
+                    {quantize(vertex.Position.x, positionStep), quantize(vertex.Position.y, positionStep),
+                     quantize(vertex.Position.z, positionStep), quantize(vertex.Normal.x, kWeldNormalStep),
+                     quantize(vertex.Normal.y, kWeldNormalStep), quantize(vertex.Normal.z, kWeldNormalStep),
+                     quantize(vertex.TexCoords.x, kWeldTexCoordStep), quantize(vertex.TexCoords.y, kWeldTexCoordStep)},
+                    inserted);
+                if (inserted)
+                    m_interleavedVertices.push_back(vertex);
+                m_interleavedIndices.push_back(index);
             }
-
-            // Add the index of the vertex to the index buffer
-            m_interleavedIndices.push_back(uniqueVertices[vertex]);
         }
     }
 
@@ -86,19 +229,23 @@ void Mesh::correctNormals()
 {
     for (auto& face : faces)
     {
+        if (face.normalIndices[0] < 0)
+            continue;
+
         glm::vec3 v0 = vertices[face.vertexIndices[0]];
         glm::vec3 v1 = vertices[face.vertexIndices[1]];
         glm::vec3 v2 = vertices[face.vertexIndices[2]];
 
         glm::vec3 edge1 = v1 - v0;
         glm::vec3 edge2 = v2 - v0;
-        glm::vec3 geometricNormal = glm::normalize(glm::cross(edge1, edge2));
+        // only the sign of the dot product is used, so neither side needs normalizing
+        glm::vec3 geometricNormal = glm::cross(edge1, edge2);
 
-        glm::vec3 storedNormal = glm::normalize(glm::vec3(
+        glm::vec3 storedNormal = glm::vec3(
             normals[face.normalIndices[0]].nx,
             normals[face.normalIndices[0]].ny,
             normals[face.normalIndices[0]].nz
-        ));
+        );
 
         float dotProduct = glm::dot(geometricNormal, storedNormal);
 
@@ -106,13 +253,230 @@ void Mesh::correctNormals()
         {
             for (int normalIndex : face.normalIndices)
             {
+                if (normalIndex < 0)
+                    continue;
                 normals[normalIndex].nx = -normals[normalIndex].nx;
                 normals[normalIndex].ny = -normals[normalIndex].ny;
                 normals[normalIndex].nz = -normals[normalIndex].nz;
             }
 
-            std::reverse(face.vertexIndices.begin(), face.vertexIndices.end());
+            // the corners keep their own normal and texture coordinate, so all three lists turn together
+            std::reverse(std::begin(face.vertexIndices), std::end(face.vertexIndices));
+            std::reverse(std::begin(face.normalIndices), std::end(face.normalIndices));
+            std::reverse(std::begin(face.texCoordIndices), std::end(face.texCoordIndices));
+        }
+    }
+}
+
+/*
+ * OBJ parsing helpers. Every helper takes the read position by reference and never reads past the
+ * end of the line it is given, so the mapped file needs no terminator.
+ */
+namespace
+{
+    // files smaller than this per thread are not worth splitting. A starting guess, not yet tuned on
+    // multi-core hardware: run --bench-obj there and move it to where the speedup starts to pay off
+    constexpr size_t kMinChunkBytes = 1024 * 1024;
+
+    /*
+     * Everything parsed from one newline-aligned slice of the file. Positive face indices are already
+     * global (0-based); relative ones are resolved against the chunk's own counts and listed in
+     * relativeSlots so the merge can add the number of elements that came before the chunk.
+     */
+    struct ObjChunk
+    {
+        const char* begin = nullptr;
+        const char* end = nullptr;
+
+        std::vector<glm::vec3> vertices;
+        std::vector<Mesh::Normal> normals;
+        std::vector<Mesh::TexCoord> texCoords;
+        std::vector<Mesh::Face> faces;
+        std::vector<uint32_t> relativeSlots; // face * 9 + attribute * 3 + corner
+
+        size_t lines = 0;
+        size_t skippedLines = 0;
+        size_t firstSkippedLine = 0; // chunk local
+        size_t invalidFaces = 0;     // set by the merge
+    };
+
+    // attribute 0 = position, 1 = normal, 2 = texture coordinate
+    inline int& faceSlot(Mesh::Face& face, uint32_t slot)
+    {
+        const uint32_t corner = slot % 3;
+        switch (slot / 3) {
+            case 0: return face.vertexIndices[corner];
+            case 1: return face.normalIndices[corner];
+            default: return face.texCoordIndices[corner];
+        }
+    }
+
+    inline void skipSpaces(const char*& cursor, const char* end)
+    {
+        while (cursor < end && (*cursor == ' ' || *cursor == '\t'))
+            ++cursor;
+    }
+
+    inline bool parseFloat(const char*& cursor, const char* end, float& value)
+    {
+        skipSpaces(cursor, end);
+        // from_chars rejects the leading '+' some exporters write
+        if (cursor < end && *cursor == '+')
+            ++cursor;
+        const auto result = std::from_chars(cursor, end, value);
+        if (result.ec != std::errc())
+            return false;
+        cursor = result.ptr;
+        return true;
+    }
+
+    /*
+     * Reads one OBJ index and makes it 0-based. Negative indices count back from the last element read,
+     * here only the chunk's elements, so they may come out negative until the merge rebases them.
+     */
+    inline bool parseIndex(const char*& cursor, const char* end, size_t count, int& index, bool& relative)
+    {
+        int value = 0;
+        const auto result = std::from_chars(cursor, end, value);
+        if (result.ec != std::errc() || value == 0)
+            return false;
+        cursor = result.ptr;
+        relative = value < 0;
+        index = relative ? static_cast<int>(count) + value : value - 1;
+        return true;
+    }
+
+    struct FaceCorner
+    {
+        int index[3];       // position, normal, texture coordinate
+        bool relative[3];
+    };
+
+    // "v", "v/vt", "v//vn" or "v/vt/vn"
+    bool parseCorner(const char*& cursor, const char* end, const ObjChunk& chunk, FaceCorner& corner)
+    {
+        corner = {{-1, -1, -1}, {false, false, false}};
+        if (!parseIndex(cursor, end, chunk.vertices.size(), corner.index[0], corner.relative[0]))
+            return false;
+        if (cursor == end || *cursor != '/')
+            return true;
+        ++cursor;
+        if (cursor < end && *cursor != '/' &&
+            !parseIndex(cursor, end, chunk.texCoords.size(), corner.index[2], corner.relative[2]))
+            return false;
+        if (cursor == end || *cursor != '/')
+            return true;
+        ++cursor;
+        return parseIndex(cursor, end, chunk.normals.size(), corner.index[1], corner.relative[1]);
+    }
+
+    void parseChunk(ObjChunk& chunk)
+    {
+        std::vector<FaceCorner> corners;
+        const char* cursor = chunk.begin;
+
+        while (cursor < chunk.end) {
+            const char* lineEnd = static_cast<const char*>(std::memchr(cursor, '\n', chunk.end - cursor));
+            if (!lineEnd)
+                lineEnd = chunk.end;
+            const char* next = lineEnd < chunk.end ? lineEnd + 1 : chunk.end;
+            if (lineEnd > cursor && lineEnd[-1] == '\r')
+                --lineEnd;
+            ++chunk.lines;
+
+            const char* p = cursor;
+            cursor = next;
+            skipSpaces(p, lineEnd);
+            if (lineEnd - p < 2 || p[0] == '#')
+                continue;
+
+            bool parsed = true;
+            if (p[0] == 'v' && (p[1] == ' ' || p[1] == '\t')) {
+                // Parse and store vertex positions, an optional w is ignored
+                glm::vec3 vertex;
+                p += 1;
+                parsed = parseFloat(p, lineEnd, vertex.x) && parseFloat(p, lineEnd, vertex.y) &&
+                         parseFloat(p, lineEnd, vertex.z);
+                if (parsed)
+                    chunk.vertices.push_back(vertex);
+            }
+            else if (p[0] == 'v' && p[1] == 'n') {
+                // Parse and store vertex normals
+                Mesh::Normal normal;
+                p += 2;
+                parsed = parseFloat(p, lineEnd, normal.nx) && parseFloat(p, lineEnd, normal.ny) &&
+                         parseFloat(p, lineEnd, normal.nz);
+                if (parsed)
+                    chunk.normals.push_back(normal);
+            }
+            else if (p[0] == 'v' && p[1] == 't') {
+                // Parse and store texture coordinates, v is optional for 1D textures
+                Mesh::TexCoord texCoord{0.0f, 0.0f};
+                p += 2;
+                parsed = parseFloat(p, lineEnd, texCoord.u);
+                if (parsed) {
+                    parseFloat(p, lineEnd, texCoord.v);
+                    chunk.texCoords.push_back(texCoord);
+                }
+            }
+            else if (p[0] == 'f' && (p[1] == ' ' || p[1] == '\t')) {
+                // Read each vertex/texture/normal index triplet in the face
+                corners.clear();
+                p += 1;
+                for (skipSpaces(p, lineEnd); p < lineEnd && parsed; skipSpaces(p, lineEnd)) {
+                    FaceCorner corner;
+                    parsed = parseCorner(p, lineEnd, chunk, corner) && (p == lineEnd || *p == ' ' || *p == '\t');
+                    corners.push_back(corner);
+                }
+                parsed = parsed && corners.size() >= 3;
+
+                // Triangulate the face if it has more than 3 vertices
+                for (size_t i = 1; parsed && i + 1 < corners.size(); ++i) {
+                    const FaceCorner* triangle[3] = {&corners[0], &corners[i], &corners[i + 1]};
+                    Mesh::Face face;
+                    for (uint32_t corner = 0; corner < 3; ++corner) {
+                        for (uint32_t attribute = 0; attribute < 3; ++attribute) {
+                            const uint32_t slot = attribute * 3 + corner;
+                            faceSlot(face, slot) = triangle[corner]->index[attribute];
+                            if (triangle[corner]->relative[attribute])
+                                chunk.relativeSlots.push_back(static_cast<uint32_t>(chunk.faces.size() * 9 + slot));
+                        }
+                    }
+                    chunk.faces.push_back(face);
+                }
+            }
+            // o, g, s, usemtl, mtllib, ... are not used
+
+            if (!parsed) {
+                if (chunk.skippedLines++ == 0)
+                    chunk.firstSkippedLine = chunk.lines;
+            }
+        }
+    }
+
+    // Cuts [begin, end) into at most chunkCount pieces, each ending just after a newline
+    std::vector<ObjChunk> splitChunks(const char* begin, const char* end, size_t chunkCount)
+    {
+        std::vector<ObjChunk> chunks;
+        const size_t chunkBytes = (static_cast<size_t>(end - begin) + chunkCount - 1) / chunkCount;
+        const char* cursor = begin;
+        while (cursor < end) {
+            const char* split = static_cast<size_t>(end - cursor) > chunkBytes ? cursor + chunkBytes : end;
+            if (split < end) {
+                const char* newline = static_cast<const char*>(std::memchr(split, '\n', end - split));
+                split = newline ? newline + 1 : end;
+            }
+            chunks.emplace_back();
+            chunks.back().begin = cursor;
+            chunks.back().end = split;
+            cursor = split;
         }
+        return chunks;
+    }
+
+    inline bool isValidIndex(int index, size_t count, bool optional)
+    {
+        return optional && index == -1 ? true : index >= 0 && static_cast<size_t>(index) < count;
     }
 }
 
@@ -122,98 +486,180 @@ void Mesh::correctNormals()
  * This method reads the provided OBJ file, extracting vertex positions, normals,
  * texture coordinates, and face indices. The mesh data is stored in the respective
  * vectors.
+ *
+ * The file is memory mapped and scanned a line at a time with memchr, numbers are read with
+ * std::from_chars straight out of the mapping, so nothing is copied or allocated per line.
+ * Large files are cut into newline-aligned chunks that are parsed on the thread pool; the chunks
+ * are then concatenated in file order with relative indices rebased, which gives exactly what a
+ * single chunk would.
  * 
  * NOTE: I assumed the OBJ file only contains ONE object/model
  *
  * @param filePath The path to the OBJ file to import.
+ * @param threadCount The most threads to parse with, 0 (or anything above hardware_concurrency()) for one
+ *                    per hardware thread.
  * @return true If the file was successfully imported.
  * @return false If the file could not be opened or read.
  */
-bool Mesh::importOBJ(const std::string& filePath) 
+bool Mesh::importOBJ(const std::string& filePath, size_t threadCount)
 {
     using namespace std::chrono;
 
     auto start = high_resolution_clock::now();
 
-    std::ifstream file(filePath);
-    if (!file.is_open()) {
+    MappedFile file(filePath);
+    if (!file.isOpen()) {
         return false;
     }
 
-    std::string line;
-    while (std::getline(file, line)) {
-        std::istringstream iss(line);
-        std::string prefix;
-        iss >> prefix;
-
-        if (prefix == "v") {
-            // Parse and store vertex positions
-            glm::vec3 vertex;
-            iss >> vertex.x >> vertex.y >> vertex.z;
-            vertices.push_back(vertex);
-        }
-        else if (prefix == "vn") {
-            // Parse and store vertex normals
-            Normal normal;
-            iss >> normal.nx >> normal.ny >> normal.nz;
-            normals.push_back(normal);
-        }
-        else if (prefix == "vt") {
-            // Parse and store texture coordinates
-            TexCoord texCoord;
-            iss >> texCoord.u >> texCoord.v;
-            texCoords.push_back(texCoord);
-        }
-        else if (prefix == "f") {
-            // Parse faces
-            std::vector<int> vertexIndices, texCoordIndices, normalIndices;
-            std::string vertexData;
-
-            // Read each vertex/texture/normal index triplet in the face
-            while (iss >> vertexData) {
-                std::istringstream vertexStream(vertexData);
-                std::string vertexIndex, texCoordIndex, normalIndex;
-
-                std::getline(vertexStream, vertexIndex, '/');
-                std::getline(vertexStream, texCoordIndex, '/');
-                std::getline(vertexStream, normalIndex, '/');
-
-                vertexIndices.push_back(std::stoi(vertexIndex) - 1);
-                if (!texCoordIndex.empty()) {
-                    texCoordIndices.push_back(std::stoi(texCoordIndex) - 1);
-                }
-                if (!normalIndex.empty()) {
-                    normalIndices.push_back(std::stoi(normalIndex) - 1);
-                }
-            }
+    // the pool always has at least one worker, so its size overstates what can run at once on a single core
+    ThreadPool& pool = ThreadPool::getInstance();
+    const size_t hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    if (threadCount == 0 || threadCount > hardwareThreads)
+        threadCount = hardwareThreads;
+    const size_t chunkCount = std::clamp<size_t>(file.size() / kMinChunkBytes, 1, threadCount);
+
+    const char* data = reinterpret_cast<const char*>(file.data());
+    std::vector<ObjChunk> chunks = splitChunks(data, data + file.size(), chunkCount);
+    pool.parallelFor(chunks.size(), [&](size_t i) { parseChunk(chunks[i]); });
+
+    // prefix sums give every chunk its place in the merged arrays
+    struct ChunkBase { size_t vertices, normals, texCoords, faces, lines; };
+    std::vector<ChunkBase> bases(chunks.size());
+    ChunkBase total{vertices.size(), normals.size(), texCoords.size(), faces.size(), 0};
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        bases[i] = total;
+        total.vertices += chunks[i].vertices.size();
+        total.normals += chunks[i].normals.size();
+        total.texCoords += chunks[i].texCoords.size();
+        total.faces += chunks[i].faces.size();
+        total.lines += chunks[i].lines;
+    }
+
+    // one chunk into an empty mesh (small files, single core) takes the chunk's arrays as they are, so
+    // the unsplit path costs no more than parsing straight into the mesh did
+    const bool adoptChunk = chunks.size() == 1 && vertices.empty() && normals.empty() && texCoords.empty() &&
+                            faces.empty();
+    if (adoptChunk) {
+        vertices = std::move(chunks[0].vertices);
+        normals = std::move(chunks[0].normals);
+        texCoords = std::move(chunks[0].texCoords);
+        faces = std::move(chunks[0].faces);
+    } else {
+        vertices.resize(total.vertices);
+        normals.resize(total.normals);
+        texCoords.resize(total.texCoords);
+        faces.resize(total.faces);
+    }
 
-            // Triangulate the face if it has more than 3 vertices
-            for (size_t i = 1; i < vertexIndices.size() - 1; ++i) {
-                Face face;
-                face.vertexIndices = { vertexIndices[0], vertexIndices[i], vertexIndices[i + 1] };
+    pool.parallelFor(chunks.size(), [&](size_t i) {
+        ObjChunk& chunk = chunks[i];
+        const ChunkBase& base = bases[i];
+        const size_t chunkFaces = adoptChunk ? faces.size() : chunk.faces.size();
+        if (!adoptChunk) {
+            std::copy(chunk.vertices.begin(), chunk.vertices.end(), vertices.begin() + base.vertices);
+            std::copy(chunk.normals.begin(), chunk.normals.end(), normals.begin() + base.normals);
+            std::copy(chunk.texCoords.begin(), chunk.texCoords.end(), texCoords.begin() + base.texCoords);
+            std::copy(chunk.faces.begin(), chunk.faces.end(), faces.begin() + base.faces);
+        }
 
-                if (!texCoordIndices.empty()) {
-                    face.texCoordIndices = { texCoordIndices[0], texCoordIndices[i], texCoordIndices[i + 1] };
-                }
-                if (!normalIndices.empty()) {
-                    face.normalIndices = { normalIndices[0], normalIndices[i], normalIndices[i + 1] };
-                }
+        const size_t attributeBase[3] = {base.vertices, base.normals, base.texCoords};
+        for (uint32_t slot : chunk.relativeSlots) {
+            int& index = faceSlot(faces[base.faces + slot / 9], slot % 9);
+            index += static_cast<int>(attributeBase[(slot % 9) / 3]);
+            // before the start of the file, kept clear of -1 which means "not referenced"
+            if (index < 0)
+                index = -2;
+        }
 
-                faces.push_back(face);
+        // an index past the end (or a relative one before the start) of the file's data drops its triangle
+        for (size_t f = base.faces; f < base.faces + chunkFaces; ++f) {
+            Face& face = faces[f];
+            bool valid = true;
+            for (int corner = 0; corner < 3; ++corner) {
+                valid = valid && isValidIndex(face.vertexIndices[corner], total.vertices, false) &&
+                        isValidIndex(face.normalIndices[corner], total.normals, true) &&
+                        isValidIndex(face.texCoordIndices[corner], total.texCoords, true);
+            }
+            if (!valid) {
+                face.vertexIndices[0] = -1;
+                chunk.invalidFaces++;
             }
         }
+
+        // the chunk's copy isn't needed past this point
+        chunk.vertices = {};
+        chunk.normals = {};
+        chunk.texCoords = {};
+        chunk.faces = {};
+        chunk.relativeSlots = {};
+    });
+
+    size_t skippedLines = 0;
+    size_t firstSkippedLine = 0;
+    size_t invalidFaces = 0;
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        if (chunks[i].skippedLines > 0 && skippedLines == 0)
+            firstSkippedLine = bases[i].lines + chunks[i].firstSkippedLine;
+        skippedLines += chunks[i].skippedLines;
+        invalidFaces += chunks[i].invalidFaces;
+    }
+
+    if (skippedLines > 0) {
+        LOG_WARNING(Mesh, "Skipped " << skippedLines << " malformed line(s) in " << filePath << ", first at line "
+                    << firstSkippedLine);
+    }
+    if (invalidFaces > 0) {
+        faces.erase(std::remove_if(faces.begin(), faces.end(), [](const Face& face) { return face.vertexIndices[0] < 0; }),
+                    faces.end());
+        LOG_WARNING(Mesh, "Dropped " << invalidFaces << " triangle(s) with out of range indices in " << filePath);
     }
 
     correctNormals();
 
     auto stop = high_resolution_clock::now();
     auto duration = duration_cast<milliseconds>(stop - start);
-    std::cout << "Time taken to load OBJ: " << duration.count() << " milliseconds" << "\tname: " << filePath << std::endl;
+    LOG_INFO(Mesh, "Time taken to load OBJ: " << duration.count() << " milliseconds" << "\tname: " << filePath
+             << "\tlines: " << total.lines << "\ttriangles: " << faces.size() << "\tchunks: " << chunks.size());
 
-    file.close();
     return true;
 }
 
+void Mesh::benchmarkImportOBJ(const std::string& filePath)
+{
+    using namespace std::chrono;
+
+    std::error_code error;
+    const auto fileBytes = std::filesystem::file_size(filePath, error);
+    if (error) {
+        LOG_ERROR(Mesh, "OBJ benchmark: cannot read " << filePath << ": " << error.message());
+        return;
+    }
+    const double fileMB = static_cast<double>(fileBytes) / (1024.0 * 1024.0);
+
+    // the first import only warms the page cache so every timed run reads from memory
+    Mesh().importOBJ(filePath, 1);
+
+    const size_t hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    double singleThreadMs = 0.0;
+    std::ostringstream report;
+    for (size_t threads = 1; threads <= hardwareThreads; ++threads) {
+        Mesh mesh;
+        auto start = high_resolution_clock::now();
+        if (!mesh.importOBJ(filePath, threads)) {
+            LOG_ERROR(Mesh, "OBJ benchmark: failed to import " << filePath);
+            return;
+        }
+        const double ms = duration<double, std::milli>(high_resolution_clock::now() - start).count();
+        if (threads == 1)
+            singleThreadMs = ms;
+
+        report << "\n\t" << threads << " thread(s): " << ms << " ms, " << (ms > 0.0 ? fileMB * 1000.0 / ms : 0.0)
+               << " MB/s, speedup " << (ms > 0.0 ? singleThreadMs / ms : 0.0) << "x";
+    }
+    LOG_INFO(Mesh, "OBJ import benchmark: " << filePath << " (" << fileMB << " MB)" << report.str());
+}
+
 // void Mesh::processVertexData() {
 //     std::unordered_map<std::string, unsigned int> uniqueVertices;
 //
@@ -70,13 +70,15 @@ public:
     struct TexCoord { float u, v; };
 
          /**
-         * @brief represents a face in the 3D model.
-         * 
+         * @brief represents a triangle in the 3D model.
+         *
+         * Polygons are fan triangulated on import. Indices are 0-based, an attribute the
+         * face does not reference (e.g. "f 1//3 2//4 3//5" has no texture coordinates) is -1.
          */
     struct Face {
-        std::vector<int> vertexIndices;
-        std::vector<int> normalIndices;
-        std::vector<int> texCoordIndices;
+        int vertexIndices[3];
+        int normalIndices[3];
+        int texCoordIndices[3];
     };
 
          /**
@@ -97,6 +99,11 @@ public:
     std::vector<Face> faces;                        ///< The list of faces in the mesh.
     Transform transform;                            ///< The transformation data for the mesh.
 
+    /// Weld quantization steps: positions as a fraction of the largest bounds extent, normals and UVs absolute.
+    static constexpr float kWeldPositionStep = 1.0f / (1 << 20);
+    static constexpr float kWeldNormalStep = 1.0f / 1024.0f;
+    static constexpr float kWeldTexCoordStep = 1.0f / 32768.0f;
+
     std::vector<VertexData> m_interleavedVertices;
     std::vector<unsigned int> m_interleavedIndices;
 
@@ -120,7 +127,16 @@ public:
 
     bool init(const std::string& filename);
 
-    void generateInterleavedData();
+        /**
+         * @brief Builds the indexed vertex buffer the renderer draws from the face list.
+         *
+         * By default corners that reference the same position/texture coordinate/normal triple share
+         * a vertex. With weld set, corners whose attributes quantize to the same values share one
+         * instead, which also merges duplicates the exporter wrote out as separate elements.
+         *
+         * @param weld Deduplicate on quantized attribute values rather than on indices.
+         */
+    void generateInterleavedData(bool weld = false);
     void correctNormals();
 
     std::vector<VertexData> getInterleavedVertices() const { return m_interleavedVertices; }
@@ -132,13 +148,25 @@ public:
          *
          * This method reads the provided OBJ file, extracting vertex positions, normals,
          * texture coordinates, and face indices. The mesh data is stored in the respective
-         * vectors.
+         * vectors. The file is memory mapped and parsed in place, negative (relative)
+         * indices are resolved against the elements read so far. Files over a megabyte
+         * are split into chunks parsed in parallel on the thread pool.
          *
          * @param filePath The path to the OBJ file to import.
+         * @param threadCount The most threads to parse with, 0 for one per hardware thread. Never more
+         *                    chunks than hardware threads, splitting further only adds merge work.
          * @return true If the file was successfully imported.
          * @return false If the file could not be opened or read.
          */
-    bool importOBJ(const std::string& filePath);
+    bool importOBJ(const std::string& filePath, size_t threadCount = 0);
+
+        /**
+         * @brief Imports the file with 1 to hardware_concurrency() threads and logs the time, MB/s and
+         * speedup over one thread for each count.
+         *
+         * @param filePath The OBJ file to parse, big enough for several 1MB chunks.
+         */
+    static void benchmarkImportOBJ(const std::string& filePath);
 
     // const VertexArray& getVertexArray() const { return m_VAO; }
     // const IndexBuffer& getIndexBuffer() const { return m_IBO; }
@@ -19,6 +19,8 @@ struct RawMeshData {
     std::vector<unsigned int> indices;
     RawMaterialData material;
     glm::mat4 transform = glm::mat4(1.0f); // Store the node's global transform
+    glm::vec3 boundsMin = glm::vec3(0.0f); // Object space AABB of the vertices
+    glm::vec3 boundsMax = glm::vec3(0.0f);
 
 };
 
@@ -5,14 +5,38 @@
 #include "Scene.h"
 
 #include <iostream>
+#include <unordered_map>
 
+#include "Components/BoundsComponent.h"
 #include "Components/MaterialComponent.h"
 #include "Components/MeshComponent.h"
 #include "Components/TransformComponent.h"
+#include "Components/WorldMatrixComponent.h"
+#include "GeometryArena.h"
 #include "Importers/ModelLoader.h"
+#include "Logger.h"
+#include "ThreadPool.h"
 
 class ModelLoader;
-Scene::Scene() = default;
+
+namespace
+{
+    // below this many dirty matrices the thread pool hand-off costs more than it saves
+    constexpr size_t kParallelWorldMatrixThreshold = 512;
+
+    void markWorldMatrixDirty(entt::registry& registry, entt::entity entity)
+    {
+        if (auto* worldMatrix = registry.try_get<WorldMatrixComponent>(entity))
+            worldMatrix->dirty = true;
+    }
+}
+
+Scene::Scene()
+{
+    m_registry.on_update<TransformComponent>().connect<&markWorldMatrixDirty>();
+    m_registry.on_construct<MeshComponent>().connect<&Scene::onMeshAddedOrRemoved>(*this);
+    m_registry.on_destroy<MeshComponent>().connect<&Scene::onMeshAddedOrRemoved>(*this);
+}
 
 Scene::~Scene() = default;
 
@@ -39,21 +63,116 @@ void Scene::loadModelToRegistry(const std::string& filepath) {
     // Load the raw model data
     LoadedModel modelData = loader.loadModel(filepath);
 
+    if (!m_geometryArena) {
+        m_geometryArena = std::make_unique<GeometryArena>(m_vertexFormat);
+    }
+
+    // Reserve the whole model up front so it lands in a single arena page (one VAO)
+    size_t totalVertices = 0, totalIndices = 0;
+    for (const auto& rawMesh : modelData.meshes) {
+        totalVertices += rawMesh.vertices.size();
+        totalIndices += rawMesh.indices.size();
+    }
+    m_geometryArena->reserve(totalVertices, totalIndices);
+
     // Process raw meshes into MeshComponents
     AssimpImporter importer;
-    for (const auto& rawMesh : modelData.meshes) {
+    for (auto& rawMesh : modelData.meshes) {
         entt::entity entity = m_registry.create();
 
-        MeshComponent meshComponent(rawMesh);
-        importer.setupMesh(meshComponent);
-        m_registry.emplace<MeshComponent>(entity, meshComponent);
+        MeshComponent meshComponent(std::move(rawMesh));
+        importer.setupMesh(meshComponent, *m_geometryArena);
+        m_registry.emplace<MeshComponent>(entity, std::move(meshComponent));
 
+        // the Euler decomposition is only for editing, the renderer keeps using the exact imported matrix
         TransformComponent transformComponent;
         transformComponent.setFromModelMatrix(rawMesh.transform);
         m_registry.emplace<TransformComponent>(entity, transformComponent);
+        m_registry.emplace<WorldMatrixComponent>(entity, rawMesh.transform);
+
+        auto& bounds = m_registry.emplace<BoundsComponent>(entity, rawMesh.boundsMin, rawMesh.boundsMax);
+        bounds.updateWorld(rawMesh.transform);
 
         // for now im hard-coding the lighting shader into this, but it needs a way of being dynamically set
         MaterialComponent materialComponent(rawMesh.material, "lightingShader");
         m_registry.emplace<MaterialComponent>(entity, materialComponent);
     }
+
+    LOG_INFO(Scene, "Geometry arena: " << m_geometryArena->getVertexCount() << " vertices, "
+                   << (m_geometryArena->getVertexCount() * m_geometryArena->getVertexStride()) / (1024 * 1024) << " MB of vertex data ("
+                   << m_geometryArena->getVertexStride() << " bytes per vertex)");
+}
+
+size_t Scene::updateWorldMatrices()
+{
+    m_dirtyEntities.clear();
+    auto view = m_registry.view<WorldMatrixComponent>();
+    for (auto entity : view) {
+        if (view.get<WorldMatrixComponent>(entity).dirty)
+            m_dirtyEntities.push_back(entity);
+    }
+    if (m_dirtyEntities.empty())
+        return 0;
+
+    // Non-const registry accessors can create a missing component pool, so the pools are looked up here
+    // on the calling thread. The workers then only touch their own entity's components in them.
+    auto& worldMatrices = m_registry.storage<WorldMatrixComponent>();
+    auto& transforms = m_registry.storage<TransformComponent>();
+    auto& bounds = m_registry.storage<BoundsComponent>();
+    auto rebuild = [&](size_t i) {
+        entt::entity entity = m_dirtyEntities[i];
+        auto& worldMatrix = worldMatrices.get(entity);
+        worldMatrix.matrix = transforms.get(entity).getModelMatrix();
+        worldMatrix.dirty = false;
+        if (bounds.contains(entity))
+            bounds.get(entity).updateWorld(worldMatrix.matrix);
+    };
+
+    if (m_dirtyEntities.size() >= kParallelWorldMatrixThreshold) {
+        ThreadPool::getInstance().parallelFor(m_dirtyEntities.size(), rebuild, 64);
+    } else {
+        for (size_t i = 0; i < m_dirtyEntities.size(); i++)
+            rebuild(i);
+    }
+    m_shadowCasterVersion++;
+    return m_dirtyEntities.size();
+}
+
+void Scene::updateTextureStreaming(size_t uploadByteBudget)
+{
+    TextureManager& textureManager = TextureManager::getInstance();
+    // acts on what the renderer reported last frame
+    textureManager.updateResidency(uploadByteBudget);
+
+    m_completedUploads.clear();
+    if (textureManager.isAsyncLoading())
+        textureManager.processUploads(uploadByteBudget, m_completedUploads);
+
+    // finished streams swap their placeholder, textures the residency manager recreated swap their old name
+    const auto& renamed = textureManager.getResidency().getRenamedTextures();
+    if (m_completedUploads.empty() && renamed.empty())
+        return;
+
+    std::unordered_map<GLuint, GLuint> replacements;
+    for (const auto& upload : m_completedUploads) {
+        replacements[upload.placeholderID] = upload.textureID;
+    }
+    for (const auto& rename : renamed) {
+        replacements[rename.oldID] = rename.newID;
+    }
+
+    auto patch = [&replacements](GLuint& textureID) {
+        auto it = replacements.find(textureID);
+        if (it != replacements.end())
+            textureID = it->second;
+    };
+
+    auto view = m_registry.view<MaterialComponent>();
+    for (auto entity : view) {
+        auto& material = view.get<MaterialComponent>(entity);
+        patch(material.baseColorTextureID);
+        patch(material.metalnessTextureID);
+        patch(material.roughnessTextureID);
+        patch(material.normalTextureID);
+    }
 }
\ No newline at end of file
@@ -5,9 +5,15 @@
 #ifndef SCENE_H
 #define SCENE_H
 
+#include <cstdint>
+#include <memory>
 #include <entt/entt.hpp>
 
+#include "CompactVertex.h"
 #include "Lights/Light.h"
+#include "TextureManager.h"
+
+class GeometryArena;
 
 class Scene
 {
@@ -22,12 +28,36 @@ public:
 
     void loadModelToRegistry(const std::string& filepath);
 
+    // GPU vertex layout for every mesh in the scene, only takes effect before the first model is loaded.
+    // The shaders have to be built with the matching CompactVertexPacking::shaderDefines().
+    void setVertexFormat(VertexFormat format) { m_vertexFormat = format; }
+    [[nodiscard]] VertexFormat getVertexFormat() const { return m_vertexFormat; }
+
+    // Rebuilds the WorldMatrixComponent (and world bounds) of every entity whose transform was patched,
+    // returns how many were rebuilt. Call once per frame before rendering.
+    size_t updateWorldMatrices();
+
+    // Bumped whenever a mesh is added, removed or moved, so cached shadow maps know to redraw
+    [[nodiscard]] uint64_t getShadowCasterVersion() const { return m_shadowCasterVersion; }
+
+    // Pumps the TextureManager's async uploads, streams/evicts mips for the residency budget and patches
+    // materials still pointing at placeholders or at textures the residency manager recreated. Both get
+    // uploadByteBudget each.
+    void updateTextureStreaming(size_t uploadByteBudget);
+
     void addLight(const Light& light) { m_lights.push_back(light); }
     [[nodiscard]] const std::vector<Light>& getLights() const { return m_lights; }
 
 private:
     entt::registry m_registry;
     std::vector<Light> m_lights;
+    std::vector<TextureUpload> m_completedUploads;
+    std::vector<entt::entity> m_dirtyEntities;
+    uint64_t m_shadowCasterVersion = 1;
+
+    void onMeshAddedOrRemoved(entt::registry& registry, entt::entity entity) { m_shadowCasterVersion++; }
+    std::unique_ptr<GeometryArena> m_geometryArena; // GPU storage for every static mesh in the scene
+    VertexFormat m_vertexFormat = VertexFormat::Full;
 
 };
 
@@ -2,16 +2,21 @@
 // Created by Shaun on 17/07/2024.
 //
 
-#include <iostream>
-
 #include "texture.h"
+#include <algorithm>
+
+#include "KtxFile.h"
+#include "Logger.h"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 
-Texture::Texture(const std::string& filePath, GLenum textureType)
+Texture::Texture(const std::string& filePath, GLenum textureType, int startMipSize)
     : m_filePath(filePath), m_textureType(textureType), m_textureID(0) {
-    loadFromFile(filePath);
+    if (KtxFile::isKtxPath(filePath))
+        loadFromKtx(filePath, startMipSize);
+    else
+        loadFromFile(filePath);
 }
 
 Texture::Texture(unsigned char* data, size_t size, GLenum textureType)
@@ -19,6 +24,14 @@ Texture::Texture(unsigned char* data, size_t size, GLenum textureType)
     loadFromMemory(data, size);
 }
 
+Texture* Texture::adopt(GLuint textureID, const std::string& filePath, GLenum textureType) {
+    Texture* texture = new Texture();
+    texture->m_textureID = textureID;
+    texture->m_filePath = filePath;
+    texture->m_textureType = textureType;
+    return texture;
+}
+
 Texture::~Texture() {
     glDeleteTextures(1, &m_textureID);
 }
@@ -33,24 +46,127 @@ void Texture::unbind() const {
     glBindTexture(m_textureType, 0);
 }
 
-void Texture::loadFromFile(const std::string& filePath) {
-    // Generate texture
-    glGenTextures(1, &m_textureID);
-    glBindTexture(m_textureType, m_textureID);
-
-    // Texture parameters
-    glTexParameteri(m_textureType, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(m_textureType, GL_TEXTURE_WRAP_T, GL_REPEAT);
+void Texture::setDefaultParameters(GLenum target) {
+    glTexParameteri(target, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(target, GL_TEXTURE_WRAP_T, GL_REPEAT);
 
-    glTexParameteri(m_textureType, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(m_textureType, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(target, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(target, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
     if (glewIsSupported("GL_EXT_texture_filter_anisotropic"))
     {
         GLfloat maxAnisotropic = 0.0f;
         glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &maxAnisotropic);
-        glTexParameterf(m_textureType, GL_TEXTURE_MAX_ANISOTROPY_EXT, maxAnisotropic);
+        glTexParameterf(target, GL_TEXTURE_MAX_ANISOTROPY_EXT, maxAnisotropic);
     }
+}
+
+int Texture::getStartLevel(const KtxFile& bakedFile, int startMipSize) {
+    const auto& levels = bakedFile.getLevels();
+    if (startMipSize <= 0)
+        return 0;
+    for (size_t i = 0; i < levels.size(); i++) {
+        if (std::max(levels[i].width, levels[i].height) <= startMipSize)
+            return static_cast<int>(i);
+    }
+    return static_cast<int>(levels.size() - 1);
+}
+
+void Texture::setBakedSource(std::shared_ptr<KtxFile> bakedFile, int baseLevel) {
+    m_bakedFile = std::move(bakedFile);
+    m_width = m_bakedFile->getWidth();
+    m_height = m_bakedFile->getHeight();
+    m_levelCount = static_cast<int>(m_bakedFile->getLevels().size());
+    m_baseLevel = baseLevel;
+    m_storageBaseLevel = baseLevel;
+}
+
+void Texture::setUncompressedSize(int width, int height, int channels) {
+    m_width = width;
+    m_height = height;
+    m_channels = channels;
+    m_baseLevel = 0;
+    // full chain, glGenerateMipmap builds every level down to 1x1
+    m_levelCount = 1;
+    for (int size = std::max(width, height); size > 1; size /= 2)
+        m_levelCount++;
+}
+
+size_t Texture::getLevelBytes(int level) const {
+    if (m_bakedFile)
+        return m_bakedFile->getLevels()[level].size;
+    const size_t width = std::max(m_width >> level, 1);
+    const size_t height = std::max(m_height >> level, 1);
+    return width * height * m_channels;
+}
+
+size_t Texture::getResidentBytes() const {
+    size_t bytes = 0;
+    for (int level = m_baseLevel; level < m_levelCount; level++)
+        bytes += getLevelBytes(level);
+    return bytes;
+}
+
+size_t Texture::streamInLevel() {
+    if (!m_bakedFile || m_baseLevel == 0)
+        return 0;
+    m_baseLevel--;
+    return getLevelBytes(m_baseLevel);
+}
+
+size_t Texture::evictLevel() {
+    if (!m_bakedFile || m_baseLevel + 1 >= m_levelCount)
+        return 0;
+    m_baseLevel++;
+    return getLevelBytes(m_baseLevel - 1);
+}
+
+size_t Texture::applyLevels() {
+    if (!m_bakedFile || m_baseLevel == m_storageBaseLevel)
+        return 0;
+
+    const auto& levels = m_bakedFile->getLevels();
+    const GLenum format = m_bakedFile->getInternalFormat();
+    const auto levelCount = static_cast<GLsizei>(m_levelCount - m_baseLevel);
+
+    GLuint textureID = 0;
+    glGenTextures(1, &textureID);
+    glBindTexture(m_textureType, textureID);
+    setDefaultParameters(m_textureType);
+    size_t uploaded = 0;
+    if (GLEW_VERSION_4_2 || GLEW_ARB_texture_storage) {
+        glTexStorage2D(m_textureType, levelCount, format, levels[m_baseLevel].width, levels[m_baseLevel].height);
+        for (GLsizei i = 0; i < levelCount; i++) {
+            const KtxFile::Level& source = levels[m_baseLevel + i];
+            glCompressedTexSubImage2D(m_textureType, i, 0, 0, source.width, source.height, format,
+                                      static_cast<GLsizei>(source.size), source.data);
+            uploaded += source.size;
+        }
+    } else {
+        glTexParameteri(m_textureType, GL_TEXTURE_MAX_LEVEL, levelCount - 1);
+        for (GLsizei i = 0; i < levelCount; i++) {
+            const KtxFile::Level& source = levels[m_baseLevel + i];
+            glCompressedTexImage2D(m_textureType, i, format, source.width, source.height, 0,
+                                   static_cast<GLsizei>(source.size), source.data);
+            uploaded += source.size;
+        }
+    }
+    glBindTexture(m_textureType, 0);
+
+    // deleting the old object is what actually hands the dropped levels back to the driver
+    glDeleteTextures(1, &m_textureID);
+    m_textureID = textureID;
+    m_storageBaseLevel = m_baseLevel;
+    return uploaded;
+}
+
+void Texture::loadFromFile(const std::string& filePath) {
+    // Generate texture
+    glGenTextures(1, &m_textureID);
+    glBindTexture(m_textureType, m_textureID);
+
+    // Texture parameters
+    setDefaultParameters(m_textureType);
 
     // Load image using stb_image
     int width, height, channels;
@@ -60,15 +176,41 @@ void Texture::loadFromFile(const std::string& filePath) {
         GLenum format = (channels == 4) ? GL_RGBA : GL_RGB; // Determine format
         glTexImage2D(m_textureType, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
         glGenerateMipmap(m_textureType);
+        setUncompressedSize(width, height, channels == 4 ? 4 : 3);
     }
     else {
-        std::cerr << "Failed to load texture: " << filePath << std::endl;
+        LOG_ERROR(Texture, "Failed to load texture: " << filePath);
     }
 
     stbi_image_free(data);
     glBindTexture(m_textureType, 0);
 }
 
+void Texture::loadFromKtx(const std::string& filePath, int startMipSize) {
+    glGenTextures(1, &m_textureID);
+    glBindTexture(m_textureType, m_textureID);
+    setDefaultParameters(m_textureType);
+
+    auto ktx = std::make_shared<KtxFile>();
+    if (ktx->open(filePath)) {
+        // every level was baked offline, nothing to generate. Levels below the start one stream in later.
+        const auto& levels = ktx->getLevels();
+        const int baseLevel = getStartLevel(*ktx, startMipSize);
+        glTexParameteri(m_textureType, GL_TEXTURE_BASE_LEVEL, baseLevel);
+        glTexParameteri(m_textureType, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(levels.size() - 1));
+        for (size_t i = baseLevel; i < levels.size(); i++) {
+            glCompressedTexImage2D(m_textureType, static_cast<GLint>(i), ktx->getInternalFormat(), levels[i].width,
+                                   levels[i].height, 0, static_cast<GLsizei>(levels[i].size), levels[i].data);
+        }
+        setBakedSource(std::move(ktx), baseLevel);
+    }
+    else {
+        LOG_ERROR(Texture, "Failed to load baked texture: " << filePath);
+    }
+
+    glBindTexture(m_textureType, 0);
+}
+
 void Texture::loadFromMemory(unsigned char* data, size_t size) {
     // Generate texture
     glGenTextures(1, &m_textureID);
@@ -88,9 +230,10 @@ void Texture::loadFromMemory(unsigned char* data, size_t size) {
         GLenum format = (channels == 4) ? GL_RGBA : GL_RGB; // Determine format
         glTexImage2D(m_textureType, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, imageData);
         glGenerateMipmap(m_textureType);
-        std::cout << "Loaded texture from memory." << std::endl;
+        setUncompressedSize(width, height, channels == 4 ? 4 : 3);
+        LOG_DEBUG(Texture, "Loaded texture from memory.");
     } else {
-        std::cerr << "Failed to load texture from memory." << std::endl;
+        LOG_ERROR(Texture, "Failed to load texture from memory.");
     }
 
     stbi_image_free(imageData);
@@ -5,9 +5,12 @@
 #ifndef TEXTURE_H
 #define TEXTURE_H
 
+#include <memory>
 #include <string>
 #include <GL/glew.h>
 
+class KtxFile;
+
 // struct Texture
 // {
 //     unsigned int id;
@@ -16,22 +19,64 @@
 
 class Texture {
 public:
-    explicit Texture(const std::string& filePath, GLenum textureType = GL_TEXTURE_2D);
+    // startMipSize > 0 only uploads the levels of a baked (.ktx) file at most that big, see TextureResidency
+    explicit Texture(const std::string& filePath, GLenum textureType = GL_TEXTURE_2D, int startMipSize = 0);
     explicit Texture(unsigned char* data, size_t size, GLenum textureType = GL_TEXTURE_2D);
     ~Texture();
 
+    // Takes ownership of a texture that was created elsewhere (e.g. streamed in by the AsyncTextureLoader)
+    static Texture* adopt(GLuint textureID, const std::string& filePath, GLenum textureType = GL_TEXTURE_2D);
+
     void bind(unsigned int slot = 0) const; // Binds texture to a texture unit
     void unbind() const;                    // Unbinds texture
 
     GLuint getID() const { return m_textureID; } // Returns the OpenGL texture ID
     const std::string& getPath() const { return m_filePath; }
 
+    // Wrap/filter/anisotropy every streamed or loaded texture uses, on whatever is bound to target
+    static void setDefaultParameters(GLenum target);
+    // First level of a baked file that is at most startMipSize on its longest side (0 = every level)
+    static int getStartLevel(const KtxFile& bakedFile, int startMipSize);
+
+    // What the GL object holds, for textures created elsewhere (adopt) set by whoever uploaded them.
+    // A baked source makes the texture streamable: levels above baseLevel can be loaded and dropped again.
+    void setBakedSource(std::shared_ptr<KtxFile> bakedFile, int baseLevel);
+    void setUncompressedSize(int width, int height, int channels);
+
+    // Residency (see TextureResidency)
+    bool isStreamable() const { return m_bakedFile != nullptr; }
+    int getWidth() const { return m_width; }
+    int getHeight() const { return m_height; }
+    int getLevelCount() const { return m_levelCount; }
+    int getBaseLevel() const { return m_baseLevel; }   // sharpest level resident once applyLevels() has run
+    size_t getLevelBytes(int level) const;
+    size_t getResidentBytes() const;
+    // Moves the base one level sharper, returns the size of the new level (0 if there is none)
+    size_t streamInLevel();
+    // Moves the base one level blurrier, returns the size of the dropped level (0 if it is the last one)
+    size_t evictLevel();
+    // GL levels can't be freed one at a time, so once the base has moved the texture is recreated with
+    // storage for exactly [base, last] and those levels uploaded again from the baked file. The GL name
+    // changes when that happens, anything holding the old one has to be patched. Returns bytes uploaded.
+    size_t applyLevels();
+
 private:
+    Texture() = default;
+
     GLuint m_textureID;      // OpenGL texture ID
     std::string m_filePath;  // Path to the texture file
     GLenum m_textureType;    // Texture type (e.g., GL_TEXTURE_2D)
 
+    int m_width = 0;
+    int m_height = 0;
+    int m_channels = 0;      // uncompressed only
+    int m_levelCount = 1;
+    int m_baseLevel = 0;
+    int m_storageBaseLevel = 0; // sharpest level the GL object actually holds
+    std::shared_ptr<KtxFile> m_bakedFile; // kept mapped so evicted levels can be reloaded
+
     void loadFromFile(const std::string& filePath); // Loads texture data from file
+    void loadFromKtx(const std::string& filePath, int startMipSize);  // Baked, block compressed file with its mip chain
     void loadFromMemory(unsigned char* data, size_t size);
 };
 
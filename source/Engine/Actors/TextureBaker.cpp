@@ -0,0 +1,107 @@
+//
+// Created by Shaun on 17/10/2026.
+//
+
+#include "TextureBaker.h"
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+#include "KtxFile.h"
+#include "Logger.h"
+#include "stb_image.h"
+
+std::string TextureBaker::getBakedPath(const std::string& sourcePath)
+{
+    return std::filesystem::path(sourcePath).replace_extension(".ktx").string();
+}
+
+std::string TextureBaker::findBakedTexture(const std::string& sourcePath)
+{
+    const std::string bakedPath = getBakedPath(sourcePath);
+    if (bakedPath == sourcePath)
+        return bakedPath; // asked for a .ktx directly
+
+    std::error_code error;
+    const auto bakedTime = std::filesystem::last_write_time(bakedPath, error);
+    if (error)
+        return "";
+    // the source may not ship with the baked files at all, that's fine
+    const auto sourceTime = std::filesystem::last_write_time(sourcePath, error);
+    if (!error && sourceTime > bakedTime) {
+        LOG_WARNING(Texture, bakedPath << " is older than its source, loading " << sourcePath << " instead (re-run TextureBake)");
+        return "";
+    }
+    return bakedPath;
+}
+
+BlockFormat TextureBaker::guessFormat(const std::string& sourcePath)
+{
+    std::string name = std::filesystem::path(sourcePath).stem().string();
+    std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return std::tolower(c); });
+    auto contains = [&name](const char* token) { return name.find(token) != std::string::npos; };
+
+    if (contains("normal") || contains("_nrm") || contains("_ddn") || contains("_bump"))
+        return BlockFormat::BC5;
+    if (contains("rough") || contains("metal") || contains("_ao") || contains("occlusion") || contains("_spec"))
+        return BlockFormat::BC4;
+    return BlockFormat::BC1;
+}
+
+bool TextureBaker::bake(const std::string& sourcePath, BlockFormat format, bool force)
+{
+    const std::string bakedPath = getBakedPath(sourcePath);
+    if (bakedPath == sourcePath)
+        return false;
+    if (!force && findBakedTexture(sourcePath) == bakedPath)
+        return true;
+
+    // always expand to RGBA8, the compressor only deals with one layout
+    int width = 0, height = 0, channels = 0;
+    std::unique_ptr<unsigned char, void (*)(void*)> pixels(stbi_load(sourcePath.c_str(), &width, &height, &channels, 4),
+                                                           stbi_image_free);
+    if (!pixels) {
+        LOG_ERROR(Texture, "TextureBake: failed to load " << sourcePath << ": " << stbi_failure_reason());
+        return false;
+    }
+
+    std::vector<unsigned char> mip(pixels.get(), pixels.get() + static_cast<size_t>(width) * height * 4);
+    pixels.reset();
+    if (format == BlockFormat::BC1) {
+        for (size_t i = 3; i < mip.size(); i += 4) {
+            if (mip[i] != 255) {
+                format = BlockFormat::BC3;
+                break;
+            }
+        }
+    }
+
+    std::vector<std::vector<unsigned char>> levels;
+    std::vector<unsigned char> nextMip;
+    int levelWidth = width, levelHeight = height;
+    while (true) {
+        levels.emplace_back();
+        TextureCompressor::compress(mip.data(), levelWidth, levelHeight, format, levels.back());
+        if (levelWidth == 1 && levelHeight == 1)
+            break;
+
+        TextureCompressor::downsample(mip.data(), levelWidth, levelHeight, nextMip);
+        mip.swap(nextMip);
+        levelWidth = std::max(levelWidth / 2, 1);
+        levelHeight = std::max(levelHeight / 2, 1);
+    }
+
+    if (!KtxFile::write(bakedPath, TextureCompressor::getGLInternalFormat(format),
+                        TextureCompressor::getGLBaseFormat(format), width, height, levels))
+        return false;
+
+    size_t bakedBytes = 0;
+    for (const auto& level : levels)
+        bakedBytes += level.size();
+    LOG_INFO(Texture, "Baked " << sourcePath << " (" << width << "x" << height << ", " << levels.size() << " levels, "
+                      << bakedBytes / 1024 << " KB)");
+    return true;
+}
@@ -0,0 +1,37 @@
+//
+// Created by Shaun on 17/10/2026.
+//
+
+#ifndef TEXTUREBAKER_H
+#define TEXTUREBAKER_H
+
+#include <string>
+
+#include "TextureCompressor.h"
+
+/**
+ * @brief Offline conversion of source images into block compressed .ktx files with full mip chains.
+ *
+ * A baked texture sits next to its source with the extension swapped for ".ktx" (textures/wall.png ->
+ * textures/wall.ktx). The TextureManager loads that file instead of the source when it is at least as
+ * new as the source, so the runtime never decodes or mips those images. Baking itself runs in the
+ * TextureBake tool (source/Tools/TextureBake.cpp), not in the engine.
+ */
+class TextureBaker
+{
+public:
+    static std::string getBakedPath(const std::string& sourcePath);
+
+    // The baked file for sourcePath if it exists and isn't older than the source, otherwise ""
+    static std::string findBakedTexture(const std::string& sourcePath);
+
+    // Decodes, mips and compresses sourcePath. BC1 is promoted to BC3 when the image actually uses its
+    // alpha channel. Skips files whose bake is up to date unless force is set.
+    static bool bake(const std::string& sourcePath, BlockFormat format, bool force = false);
+
+    // Format for an image file when the caller doesn't know how it is used, guessed from the file name:
+    // normal maps -> BC5, roughness/metalness/AO -> BC4, anything else is colour (BC1)
+    static BlockFormat guessFormat(const std::string& sourcePath);
+};
+
+#endif //TEXTUREBAKER_H
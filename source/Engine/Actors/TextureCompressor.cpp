@@ -0,0 +1,228 @@
+//
+// Created by Shaun on 17/10/2026.
+//
+
+#include "TextureCompressor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <GL/glew.h>
+
+namespace
+{
+    uint16_t packRgb565(const float color[3])
+    {
+        auto quantize = [](float value, int maxValue) {
+            return static_cast<uint16_t>(std::clamp(static_cast<int>(value / 255.0f * maxValue + 0.5f), 0, maxValue));
+        };
+        return static_cast<uint16_t>((quantize(color[0], 31) << 11) | (quantize(color[1], 63) << 5) | quantize(color[2], 31));
+    }
+
+    void unpackRgb565(uint16_t packed, int color[3])
+    {
+        const int r = (packed >> 11) & 31, g = (packed >> 5) & 63, b = packed & 31;
+        color[0] = (r << 3) | (r >> 2);
+        color[1] = (g << 2) | (g >> 4);
+        color[2] = (b << 3) | (b >> 2);
+    }
+}
+
+uint32_t TextureCompressor::getGLInternalFormat(BlockFormat format)
+{
+    switch (format) {
+        case BlockFormat::BC1: return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+        case BlockFormat::BC3: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        case BlockFormat::BC4: return GL_COMPRESSED_RED_RGTC1;
+        case BlockFormat::BC5: return GL_COMPRESSED_RG_RGTC2;
+    }
+    return 0;
+}
+
+uint32_t TextureCompressor::getGLBaseFormat(BlockFormat format)
+{
+    switch (format) {
+        case BlockFormat::BC1: return GL_RGB;
+        case BlockFormat::BC3: return GL_RGBA;
+        case BlockFormat::BC4: return GL_RED;
+        case BlockFormat::BC5: return GL_RG;
+    }
+    return 0;
+}
+
+size_t TextureCompressor::getBlockBytes(BlockFormat format)
+{
+    return (format == BlockFormat::BC1 || format == BlockFormat::BC4) ? 8 : 16;
+}
+
+size_t TextureCompressor::getCompressedSize(BlockFormat format, int width, int height)
+{
+    const size_t blocksX = (static_cast<size_t>(width) + 3) / 4;
+    const size_t blocksY = (static_cast<size_t>(height) + 3) / 4;
+    return blocksX * blocksY * getBlockBytes(format);
+}
+
+void TextureCompressor::compress(const unsigned char* rgba, int width, int height, BlockFormat format,
+                                 std::vector<unsigned char>& out)
+{
+    out.resize(getCompressedSize(format, width, height));
+    unsigned char* dst = out.data();
+
+    unsigned char block[16][4];
+    for (int blockY = 0; blockY < height; blockY += 4) {
+        for (int blockX = 0; blockX < width; blockX += 4) {
+            for (int y = 0; y < 4; y++) {
+                const int sourceY = std::min(blockY + y, height - 1);
+                for (int x = 0; x < 4; x++) {
+                    const int sourceX = std::min(blockX + x, width - 1);
+                    std::memcpy(block[y * 4 + x], rgba + (static_cast<size_t>(sourceY) * width + sourceX) * 4, 4);
+                }
+            }
+
+            switch (format) {
+                case BlockFormat::BC1:
+                    encodeColorBlock(block, dst);
+                    break;
+                case BlockFormat::BC3:
+                    encodeChannelBlock(block, 3, dst);
+                    encodeColorBlock(block, dst + 8);
+                    break;
+                case BlockFormat::BC4:
+                    encodeChannelBlock(block, 0, dst);
+                    break;
+                case BlockFormat::BC5:
+                    encodeChannelBlock(block, 0, dst);
+                    encodeChannelBlock(block, 1, dst + 8);
+                    break;
+            }
+            dst += getBlockBytes(format);
+        }
+    }
+}
+
+void TextureCompressor::downsample(const unsigned char* rgba, int width, int height, std::vector<unsigned char>& out)
+{
+    const int mipWidth = std::max(width / 2, 1);
+    const int mipHeight = std::max(height / 2, 1);
+    out.resize(static_cast<size_t>(mipWidth) * mipHeight * 4);
+
+    for (int y = 0; y < mipHeight; y++) {
+        const int y0 = std::min(y * 2, height - 1), y1 = std::min(y * 2 + 1, height - 1);
+        for (int x = 0; x < mipWidth; x++) {
+            const int x0 = std::min(x * 2, width - 1), x1 = std::min(x * 2 + 1, width - 1);
+            const unsigned char* texels[4] = {
+                rgba + (static_cast<size_t>(y0) * width + x0) * 4, rgba + (static_cast<size_t>(y0) * width + x1) * 4,
+                rgba + (static_cast<size_t>(y1) * width + x0) * 4, rgba + (static_cast<size_t>(y1) * width + x1) * 4
+            };
+            unsigned char* dst = out.data() + (static_cast<size_t>(y) * mipWidth + x) * 4;
+            for (int c = 0; c < 4; c++)
+                dst[c] = static_cast<unsigned char>((texels[0][c] + texels[1][c] + texels[2][c] + texels[3][c] + 2) / 4);
+        }
+    }
+}
+
+void TextureCompressor::encodeColorBlock(const unsigned char block[16][4], unsigned char* out)
+{
+    // principal axis of the block's colours, a few power iterations on the covariance are plenty
+    float mean[3] = {0.0f, 0.0f, 0.0f};
+    for (int i = 0; i < 16; i++) {
+        for (int c = 0; c < 3; c++)
+            mean[c] += block[i][c];
+    }
+    for (float& m : mean)
+        m /= 16.0f;
+
+    float covariance[6] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f}; // rr rg rb gg gb bb
+    for (int i = 0; i < 16; i++) {
+        const float r = block[i][0] - mean[0], g = block[i][1] - mean[1], b = block[i][2] - mean[2];
+        covariance[0] += r * r; covariance[1] += r * g; covariance[2] += r * b;
+        covariance[3] += g * g; covariance[4] += g * b; covariance[5] += b * b;
+    }
+
+    float axis[3] = {1.0f, 1.0f, 1.0f};
+    for (int iteration = 0; iteration < 4; iteration++) {
+        const float x = covariance[0] * axis[0] + covariance[1] * axis[1] + covariance[2] * axis[2];
+        const float y = covariance[1] * axis[0] + covariance[3] * axis[1] + covariance[4] * axis[2];
+        const float z = covariance[2] * axis[0] + covariance[4] * axis[1] + covariance[5] * axis[2];
+        const float length = std::max({std::abs(x), std::abs(y), std::abs(z)});
+        if (length < 1e-6f)
+            break; // flat block, any axis will do
+        axis[0] = x / length; axis[1] = y / length; axis[2] = z / length;
+    }
+
+    // the extremes along that axis become the endpoints
+    float minProjection = 1e30f, maxProjection = -1e30f;
+    int minIndex = 0, maxIndex = 0;
+    for (int i = 0; i < 16; i++) {
+        const float projection = block[i][0] * axis[0] + block[i][1] * axis[1] + block[i][2] * axis[2];
+        if (projection < minProjection) { minProjection = projection; minIndex = i; }
+        if (projection > maxProjection) { maxProjection = projection; maxIndex = i; }
+    }
+
+    const float maxColor[3] = {float(block[maxIndex][0]), float(block[maxIndex][1]), float(block[maxIndex][2])};
+    const float minColor[3] = {float(block[minIndex][0]), float(block[minIndex][1]), float(block[minIndex][2])};
+    uint16_t color0 = packRgb565(maxColor);
+    uint16_t color1 = packRgb565(minColor);
+    // color0 > color1 selects the four colour mode (BC1's three colour mode would give us punch-through alpha)
+    if (color0 < color1)
+        std::swap(color0, color1);
+
+    uint32_t indices = 0;
+    if (color0 != color1) {
+        int palette[4][3];
+        unpackRgb565(color0, palette[0]);
+        unpackRgb565(color1, palette[1]);
+        for (int c = 0; c < 3; c++) {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+
+        for (int i = 0; i < 16; i++) {
+            int best = 0, bestError = 1 << 30;
+            for (int p = 0; p < 4; p++) {
+                int error = 0;
+                for (int c = 0; c < 3; c++) {
+                    const int delta = block[i][c] - palette[p][c];
+                    error += delta * delta;
+                }
+                if (error < bestError) {
+                    bestError = error;
+                    best = p;
+                }
+            }
+            indices |= static_cast<uint32_t>(best) << (i * 2);
+        }
+    }
+
+    out[0] = static_cast<unsigned char>(color0 & 0xFF);
+    out[1] = static_cast<unsigned char>(color0 >> 8);
+    out[2] = static_cast<unsigned char>(color1 & 0xFF);
+    out[3] = static_cast<unsigned char>(color1 >> 8);
+    for (int i = 0; i < 4; i++)
+        out[4 + i] = static_cast<unsigned char>(indices >> (i * 8));
+}
+
+void TextureCompressor::encodeChannelBlock(const unsigned char block[16][4], int channel, unsigned char* out)
+{
+    int maxValue = 0, minValue = 255;
+    for (int i = 0; i < 16; i++) {
+        maxValue = std::max<int>(maxValue, block[i][channel]);
+        minValue = std::min<int>(minValue, block[i][channel]);
+    }
+
+    // value0 > value1 is the eight value mode: 0 = max, 1 = min, 2..7 interpolate from max towards min
+    uint64_t indices = 0;
+    if (maxValue != minValue) {
+        const int range = maxValue - minValue;
+        for (int i = 0; i < 16; i++) {
+            const int step = ((maxValue - block[i][channel]) * 7 + range / 2) / range; // 0 = max ... 7 = min
+            const uint64_t index = step == 0 ? 0 : (step == 7 ? 1 : step + 1);
+            indices |= index << (i * 3);
+        }
+    }
+
+    out[0] = static_cast<unsigned char>(maxValue);
+    out[1] = static_cast<unsigned char>(minValue);
+    for (int i = 0; i < 6; i++)
+        out[2 + i] = static_cast<unsigned char>(indices >> (i * 8));
+}
@@ -0,0 +1,48 @@
+//
+// Created by Shaun on 17/10/2026.
+//
+
+#ifndef TEXTURECOMPRESSOR_H
+#define TEXTURECOMPRESSOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Block compressed formats the texture baker can produce, all 4x4 blocks
+enum class BlockFormat : uint8_t
+{
+    BC1,    // RGB, 8 bytes per block (colour without alpha)
+    BC3,    // RGBA, 16 bytes per block (colour with alpha)
+    BC4,    // R, 8 bytes per block (roughness/metalness etc.)
+    BC5     // RG, 16 bytes per block (tangent space normals, Z rebuilt in the shader)
+};
+
+/**
+ * @brief CPU encoders for BC1/BC3/BC4/BC5 plus the box filter used to build mip chains offline.
+ *
+ * Quality over speed is not the goal here: colour endpoints come from the principal axis of the block
+ * and every texel picks its nearest palette entry, which is close to what the driver's runtime
+ * compressor does. Inputs are always tightly packed RGBA8.
+ */
+class TextureCompressor
+{
+public:
+    // GL internal format / base internal format for the KTX header and glCompressedTexImage2D
+    static uint32_t getGLInternalFormat(BlockFormat format);
+    static uint32_t getGLBaseFormat(BlockFormat format);
+    static size_t getBlockBytes(BlockFormat format);
+    static size_t getCompressedSize(BlockFormat format, int width, int height);
+
+    // Compresses one RGBA8 image, partial edge blocks repeat the last row/column
+    static void compress(const unsigned char* rgba, int width, int height, BlockFormat format, std::vector<unsigned char>& out);
+
+    // Halves an RGBA8 image with a 2x2 box filter, odd edges are clamped (same result as glGenerateMipmap)
+    static void downsample(const unsigned char* rgba, int width, int height, std::vector<unsigned char>& out);
+
+private:
+    static void encodeColorBlock(const unsigned char block[16][4], unsigned char* out);
+    static void encodeChannelBlock(const unsigned char block[16][4], int channel, unsigned char* out);
+};
+
+#endif //TEXTURECOMPRESSOR_H
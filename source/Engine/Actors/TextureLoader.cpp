@@ -3,12 +3,12 @@
 //
 
 #include "TextureLoader.h"
+#include "Logger.h"
 
-#include <iostream>
 
-Texture* TextureLoader::loadTexture(const std::string& filePath) {
+Texture* TextureLoader::loadTexture(const std::string& filePath, int startMipSize) {
     // Create and return a new Texture object
-    return new Texture(filePath);
+    return new Texture(filePath, GL_TEXTURE_2D, startMipSize);
 }
 
 Texture* TextureLoader::loadFromGLTF(const std::string& gltfTexturePath) {
@@ -24,7 +24,7 @@ Texture* TextureLoader::loadEmbeddedTexture(aiTexture* embeddedTexture) {
     } else {
         // Uncompressed texture (e.g., BMP)
         // Handle uncompressed texture data
-        std::cerr << "Uncompressed embedded textures are not supported yet." << std::endl;
+        LOG_ERROR(Texture, "Uncompressed embedded textures are not supported yet.");
         return nullptr;
     }
 }
\ No newline at end of file
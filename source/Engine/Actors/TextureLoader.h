@@ -12,7 +12,7 @@
 
 class TextureLoader {
 public:
-    static Texture* loadTexture(const std::string& filePath);
+    static Texture* loadTexture(const std::string& filePath, int startMipSize = 0);
     static Texture* loadFromGLTF(const std::string& gltfTexturePath);
     static Texture* loadEmbeddedTexture(aiTexture* embeddedTexture);
 };
@@ -11,6 +11,7 @@
 
 #include <assimp/texture.h>
 
+#include "TextureBaker.h"
 #include "TextureLoader.h"
 
 TextureManager& TextureManager::getInstance() {
@@ -23,20 +24,38 @@ GLuint TextureManager::getTexture(const std::string& filePath) {
 	if (it != m_textureCache.end()) {
 		return it->second->getID(); // Return the OpenGL texture ID
 	}
+	auto pending = m_pendingTextures.find(filePath);
+	if (pending != m_pendingTextures.end()) {
+		return pending->second; // Still streaming, hand out the placeholder
+	}
 	return 0; // Texture not found
 }
 
-GLuint TextureManager::loadTexture(const std::string& filePath) {
+GLuint TextureManager::loadTexture(const std::string& filePath, TextureUsage usage) {
 	// Check if the texture is already cached
 	auto it = m_textureCache.find(filePath);
 	if (it != m_textureCache.end()) {
 		return it->second->getID();
 	}
 
-	// Load the texture
-	Texture* texture = TextureLoader::loadTexture(filePath);
+	if (m_asyncLoader) {
+		// Already requested, share the same placeholder so one patch covers every material using it
+		auto pending = m_pendingTextures.find(filePath);
+		if (pending != m_pendingTextures.end()) {
+			return pending->second;
+		}
+
+		GLuint placeholderID = createPlaceholder(usage);
+		m_pendingTextures[filePath] = placeholderID;
+		m_asyncLoader->request(filePath, placeholderID, resolveLoadPath(filePath), m_residency.getStartMipSize());
+		return placeholderID;
+	}
+
+	// Load the texture, still cached under the source path so materials and the mesh cache never see the .ktx
+	Texture* texture = TextureLoader::loadTexture(resolveLoadPath(filePath), m_residency.getStartMipSize());
 	if (texture) {
 		m_textureCache[filePath] = texture; // Cache the texture
+		m_residency.add(texture);
 		return texture->getID();
 	}
 	return 0; // Failed to load texture
@@ -47,10 +66,123 @@ void TextureManager::clear() {
 		delete pair.second; // Free texture memory
 	}
 	m_textureCache.clear();
+	m_residency.clear();
+
+	// Drop anything still streaming, restarting the loader so in-flight decodes are discarded
+	if (m_asyncLoader) {
+		m_asyncLoader = std::make_unique<AsyncTextureLoader>(m_asyncWorkerCount, kMaxDecodedTextures);
+	}
+	// Materials still point at these placeholders, so they are only freed after the next
+	// processUploads() has reported them as swapped to texture 0
+	for (auto& pair : m_pendingTextures) {
+		TextureUpload cancelled;
+		cancelled.filePath = pair.first;
+		cancelled.placeholderID = pair.second;
+		m_cancelledUploads.push_back(std::move(cancelled));
+	}
+	m_pendingTextures.clear();
+}
+
+void TextureManager::setAsyncLoading(bool asyncLoading, size_t workerCount) {
+	if (!asyncLoading) {
+		m_asyncLoader.reset();
+		return;
+	}
+	if (m_asyncLoader) {
+		return;
+	}
+
+	// leave a core for the GL thread
+	if (workerCount == 0) {
+		unsigned int hardwareThreads = std::thread::hardware_concurrency();
+		workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+	}
+	m_asyncWorkerCount = workerCount;
+	m_asyncLoader = std::make_unique<AsyncTextureLoader>(workerCount, kMaxDecodedTextures);
+}
+
+bool TextureManager::hasPendingTextures() const {
+	return !m_pendingTextures.empty();
+}
+
+void TextureManager::processUploads(size_t byteBudget, std::vector<TextureUpload>& completed) {
+	// Placeholders swapped last call have been patched out of every material by now
+	releaseRetiredPlaceholders();
+
+	for (auto& cancelled : m_cancelledUploads) {
+		m_retiredPlaceholders.push_back(cancelled.placeholderID);
+		completed.push_back(std::move(cancelled));
+	}
+	m_cancelledUploads.clear();
+
+	if (!m_asyncLoader) {
+		return;
+	}
+
+	size_t firstCompleted = completed.size();
+	m_asyncLoader->processUploads(byteBudget, completed);
+
+	for (size_t i = firstCompleted; i < completed.size(); i++) {
+		const TextureUpload& upload = completed[i];
+		if (upload.textureID != 0) {
+			Texture* texture = Texture::adopt(upload.textureID, upload.filePath);
+			if (upload.bakedFile) {
+				texture->setBakedSource(upload.bakedFile, upload.baseLevel);
+			} else {
+				texture->setUncompressedSize(upload.width, upload.height, upload.channels);
+			}
+			m_textureCache[upload.filePath] = texture;
+			m_residency.add(texture);
+		}
+		m_pendingTextures.erase(upload.filePath);
+		m_retiredPlaceholders.push_back(upload.placeholderID);
+	}
+}
+
+std::string TextureManager::resolveLoadPath(const std::string& filePath) const {
+	// RGTC is core, S3TC (BC1/BC3) is an extension every desktop driver exposes - but check anyway
+	if (!m_preferBaked || !GLEW_EXT_texture_compression_s3tc) {
+		return filePath;
+	}
+	std::string bakedPath = TextureBaker::findBakedTexture(filePath);
+	return bakedPath.empty() ? filePath : bakedPath;
+}
+
+GLuint TextureManager::createPlaceholder(TextureUsage usage) {
+	// Neutral values so partially loaded materials still shade sensibly
+	unsigned char pixel[4] = {128, 128, 128, 255};
+	if (usage == TextureUsage::Normal) {
+		pixel[0] = 128; pixel[1] = 128; pixel[2] = 255;
+	} else if (usage == TextureUsage::Data) {
+		pixel[0] = pixel[1] = pixel[2] = 255;
+	}
+
+	GLuint placeholderID = 0;
+	glGenTextures(1, &placeholderID);
+	glBindTexture(GL_TEXTURE_2D, placeholderID);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixel);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	return placeholderID;
+}
+
+void TextureManager::releaseRetiredPlaceholders() {
+	if (!m_retiredPlaceholders.empty()) {
+		glDeleteTextures(static_cast<GLsizei>(m_retiredPlaceholders.size()), m_retiredPlaceholders.data());
+		m_retiredPlaceholders.clear();
+	}
 }
 
 TextureManager::~TextureManager() {
+	m_asyncLoader.reset(); // Stop the decode workers before tearing down the cache
 	clear(); // Ensure all textures are freed
+	// nothing is left to reference the placeholders at shutdown
+	for (const auto& cancelled : m_cancelledUploads) {
+		m_retiredPlaceholders.push_back(cancelled.placeholderID);
+	}
+	m_cancelledUploads.clear();
+	releaseRetiredPlaceholders();
 }
 
 GLuint TextureManager::loadEmbeddedTexture(aiTexture* embeddedTexture) {
@@ -67,6 +199,7 @@ GLuint TextureManager::loadEmbeddedTexture(aiTexture* embeddedTexture) {
 	Texture* texture = TextureLoader::loadEmbeddedTexture(embeddedTexture);
 	if (texture) {
 		m_textureCache[textureKey] = texture; // Cache the texture
+		m_residency.add(texture);
 		return texture->getID();
 	}
 	return 0; // Failed to load texture
@@ -14,27 +14,77 @@
 
 
 #include <GL/glew.h>
+#include <memory>
 #include <string>
 #include <texture.h>
 #include <unordered_map>
+#include <vector>
 #include <assimp/texture.h>
 
+#include "AsyncTextureLoader.h"
+#include "TextureResidency.h"
+
+// What a texture is sampled as - only used to pick a sensible placeholder while it streams in
+enum class TextureUsage
+{
+	Color,		// albedo/base colour
+	Normal,		// tangent space normal map
+	Data		// roughness/metalness etc.
+};
+
 class TextureManager
 {
 public:
 	static TextureManager& getInstance();
 
 	GLuint getTexture(const std::string& filePath);
-	GLuint loadTexture(const std::string& filePath);
+	// In async mode this returns a unique 1x1 placeholder texture until the real upload completes
+	GLuint loadTexture(const std::string& filePath, TextureUsage usage = TextureUsage::Color);
 	GLuint loadEmbeddedTexture(aiTexture* embeddedTexture);
-	void clear(); // Clears the cache
+	void clear(); // Clears the cache, placeholders still streaming are reported by the next processUploads()
+
+	// Async mode decodes on worker threads and uploads from processUploads(), call before loading a scene
+	void setAsyncLoading(bool asyncLoading, size_t workerCount = 0);
+	[[nodiscard]] bool isAsyncLoading() const { return m_asyncLoader != nullptr; }
+	[[nodiscard]] bool hasPendingTextures() const;
+
+	// GL thread, once per frame. Uploads at most byteBudget bytes and reports the placeholder -> texture
+	// swaps that completed so materials can be patched (to 0 for streams clear() dropped). Placeholders
+	// are freed on the following call.
+	void processUploads(size_t byteBudget, std::vector<TextureUpload>& completed);
+
+	// Load <name>.ktx (see TextureBaker) instead of the source image when it is there and up to date.
+	// On by default, turn it off to compare against the runtime decoded path.
+	void setPreferBaked(bool preferBaked) { m_preferBaked = preferBaked; }
+	[[nodiscard]] bool isPreferringBaked() const { return m_preferBaked; }
+
+	// VRAM budget and mip streaming for everything loaded through here, see TextureResidency.
+	// The renderer reports usage with markTextureUsed(), updateResidency() acts on it once per frame.
+	TextureResidency& getResidency() { return m_residency; }
+	void markTextureUsed(GLuint textureID, float screenPixels) { m_residency.markUsed(textureID, screenPixels); }
+	void updateResidency(size_t uploadByteBudget) { m_residency.update(uploadByteBudget); }
 
 private:
 	TextureManager() = default;
 	~TextureManager();
 
+	// decoded images allowed to wait for upload at once (a 4K RGBA image is 64MB)
+	static constexpr size_t kMaxDecodedTextures = 4;
+
+	GLuint createPlaceholder(TextureUsage usage);
+	std::string resolveLoadPath(const std::string& filePath) const;
+	void releaseRetiredPlaceholders();
+
 	std::unordered_map<std::string, Texture*> m_textureCache; // Map of texture ID -> Texture*
 
+	std::unique_ptr<AsyncTextureLoader> m_asyncLoader;
+	size_t m_asyncWorkerCount = 0;
+	std::unordered_map<std::string, GLuint> m_pendingTextures; // file path -> placeholder ID
+	std::vector<GLuint> m_retiredPlaceholders;
+	std::vector<TextureUpload> m_cancelledUploads; // dropped by clear(), textureID 0
+	bool m_preferBaked = true;
+	TextureResidency m_residency;
+
 	TextureManager(const TextureManager&) = delete;
 	TextureManager& operator=(const TextureManager&) = delete;
 };
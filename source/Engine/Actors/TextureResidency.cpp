@@ -0,0 +1,176 @@
+//
+// Created by Shaun on 17/10/2026.
+//
+
+#include "TextureResidency.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Texture.h"
+
+void TextureResidency::add(Texture* texture)
+{
+    // counts as drawn now, so nothing is evicted before the renderer has had a chance to report it
+    Entry entry{texture, texture->getBaseLevel(), texture->getBaseLevel(), m_frame};
+    m_entryByID[texture->getID()] = m_entries.size();
+    m_entries.push_back(entry);
+    m_stats.residentBytes += texture->getResidentBytes();
+}
+
+void TextureResidency::clear()
+{
+    m_entries.clear();
+    m_entryByID.clear();
+    m_stats.residentBytes = 0;
+}
+
+void TextureResidency::markUsed(GLuint textureID, float screenPixels)
+{
+    auto it = m_entryByID.find(textureID);
+    if (it == m_entryByID.end())
+        return; // placeholder or not a managed texture
+
+    Entry& entry = m_entries[it->second];
+    entry.lastUsedFrame = m_frame;
+    entry.screenPixels = std::max(entry.screenPixels, screenPixels);
+}
+
+int TextureResidency::getWantedLevel(const Entry& entry) const
+{
+    const Texture& texture = *entry.texture;
+    const float size = static_cast<float>(std::max(texture.getWidth(), texture.getHeight()));
+    const float level = std::log2(size / std::max(entry.screenPixels, 1.0f)) - kDetailBias;
+    return std::clamp(static_cast<int>(std::floor(level)), 0, entry.minLevel);
+}
+
+size_t TextureResidency::evictLevel(Entry& entry)
+{
+    const size_t bytes = entry.texture->evictLevel();
+    if (bytes > 0) {
+        m_stats.residentBytes -= bytes;
+        m_stats.evictedBytes += bytes;
+        m_stats.levelsEvicted++;
+    }
+    return bytes;
+}
+
+bool TextureResidency::makeRoom(size_t bytes, uint64_t frame)
+{
+    const size_t budget = m_stats.budgetBytes;
+    if (budget == 0 || m_stats.residentBytes + bytes <= budget)
+        return true;
+
+    std::vector<size_t> candidates;
+    for (size_t i = 0; i < m_entries.size(); i++) {
+        const Entry& entry = m_entries[i];
+        if (entry.texture->isStreamable() && entry.lastUsedFrame < frame && entry.texture->getBaseLevel() < entry.minLevel)
+            candidates.push_back(i);
+    }
+    std::sort(candidates.begin(), candidates.end(), [this](size_t a, size_t b) {
+        return m_entries[a].lastUsedFrame < m_entries[b].lastUsedFrame;
+    });
+
+    for (size_t index : candidates) {
+        Entry& entry = m_entries[index];
+        while (m_stats.residentBytes + bytes > budget && entry.texture->getBaseLevel() < entry.minLevel) {
+            evictLevel(entry);
+            // it has to be streamed back in before it's sharper than it is now
+            entry.wantedLevel = std::max(entry.wantedLevel, entry.texture->getBaseLevel());
+        }
+        if (m_stats.residentBytes + bytes <= budget)
+            return true;
+    }
+    return m_stats.residentBytes + bytes <= budget;
+}
+
+void TextureResidency::update(size_t uploadByteBudget)
+{
+    m_stats.streamedBytes = 0;
+    m_stats.evictedBytes = 0;
+    m_stats.levelsStreamed = 0;
+    m_stats.levelsEvicted = 0;
+    m_renamed.clear();
+
+    if (m_streaming) {
+        // what each texture wants from what was drawn last frame, textures left alone for long enough fall
+        // back to their tail, ones drawn recently keep what they had
+        for (Entry& entry : m_entries) {
+            if (!entry.texture->isStreamable())
+                continue;
+            if (entry.lastUsedFrame == m_frame)
+                entry.wantedLevel = getWantedLevel(entry);
+            else if (m_frame - entry.lastUsedFrame > kEvictAfterFrames)
+                entry.wantedLevel = entry.minLevel;
+            entry.screenPixels = 0.0f;
+
+            while (entry.texture->getBaseLevel() < entry.wantedLevel && evictLevel(entry) > 0) {}
+        }
+
+        // over budget (it shrank, or a lot became visible at once): least recently used levels go first
+        if (!makeRoom(0, m_frame))
+            makeRoom(0, m_frame + 1);
+
+        // most recently drawn and furthest from what they want first
+        m_order.clear();
+        for (size_t i = 0; i < m_entries.size(); i++) {
+            if (m_entries[i].texture->getBaseLevel() > m_entries[i].wantedLevel)
+                m_order.push_back(i);
+        }
+        std::sort(m_order.begin(), m_order.end(), [this](size_t a, size_t b) {
+            const Entry& entryA = m_entries[a];
+            const Entry& entryB = m_entries[b];
+            if (entryA.lastUsedFrame != entryB.lastUsedFrame)
+                return entryA.lastUsedFrame > entryB.lastUsedFrame;
+            return entryA.texture->getBaseLevel() - entryA.wantedLevel > entryB.texture->getBaseLevel() - entryB.wantedLevel;
+        });
+
+        // applyLevels() uploads the whole new chain, so the first level streamed into a texture also
+        // pays for re-uploading the levels it already had
+        size_t plannedUploadBytes = 0;
+        for (size_t index : m_order) {
+            Entry& entry = m_entries[index];
+            size_t keptBytes = entry.texture->getResidentBytes();
+            while (entry.texture->getBaseLevel() > entry.wantedLevel) {
+                const size_t bytes = entry.texture->getLevelBytes(entry.texture->getBaseLevel() - 1);
+                const size_t uploadBytes = bytes + keptBytes;
+                // always let one level through, a single level bigger than the budget would never load otherwise
+                if (plannedUploadBytes > 0 && plannedUploadBytes + uploadBytes > uploadByteBudget)
+                    break;
+                // only older textures make way, otherwise two visible ones could keep evicting each other
+                if (!makeRoom(bytes, entry.lastUsedFrame))
+                    break;
+
+                m_stats.residentBytes += entry.texture->streamInLevel();
+                plannedUploadBytes += uploadBytes;
+                keptBytes = 0;
+                m_stats.levelsStreamed++;
+            }
+            if (plannedUploadBytes >= uploadByteBudget)
+                break;
+        }
+
+        // recreate every texture whose base moved, the dropped levels are only really freed here
+        for (Entry& entry : m_entries) {
+            const GLuint oldID = entry.texture->getID();
+            m_stats.streamedBytes += entry.texture->applyLevels();
+            const GLuint newID = entry.texture->getID();
+            if (newID != oldID) {
+                m_entryByID.erase(oldID);
+                m_entryByID[newID] = static_cast<size_t>(&entry - m_entries.data());
+                m_renamed.push_back({oldID, newID});
+            }
+        }
+    }
+
+    m_stats.textures = static_cast<unsigned int>(m_entries.size());
+    m_stats.streamableTextures = 0;
+    m_stats.fullResolution = 0;
+    for (const Entry& entry : m_entries) {
+        if (entry.texture->isStreamable()) {
+            m_stats.streamableTextures++;
+            m_stats.fullResolution += entry.texture->getBaseLevel() == 0 ? 1 : 0;
+        }
+    }
+    m_frame++;
+}
@@ -0,0 +1,108 @@
+//
+// Created by Shaun on 17/10/2026.
+//
+
+#ifndef TEXTURERESIDENCY_H
+#define TEXTURERESIDENCY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <GL/glew.h>
+
+class Texture;
+
+// What the residency manager did this frame, plus where the totals stand
+struct TextureResidencyStats
+{
+    size_t residentBytes = 0;       // every tracked texture's resident levels
+    size_t budgetBytes = 0;         // 0 = unlimited
+    size_t streamedBytes = 0;       // uploaded by update() this frame, kept levels re-uploaded on eviction included
+    size_t evictedBytes = 0;        // released by update() this frame
+    unsigned int textures = 0;
+    unsigned int streamableTextures = 0;  // baked, the only ones whose mips can come and go
+    unsigned int fullResolution = 0;      // streamable textures with level 0 resident
+    unsigned int levelsStreamed = 0;
+    unsigned int levelsEvicted = 0;
+};
+
+// A texture update() recreated with a different mip range, whatever still holds oldID has to use newID
+struct TextureRename
+{
+    GLuint oldID;
+    GLuint newID;
+};
+
+/**
+ * @brief Keeps the textures the TextureManager owns inside a VRAM budget.
+ *
+ * The renderer reports every texture it draws with together with how many pixels across the surface
+ * covers on screen (markUsed). Once per frame update() turns that into a wanted mip level per texture,
+ * drops the top levels of textures that haven't been drawn for kEvictAfterFrames, evicts least recently
+ * used levels while over budget, and streams wanted levels back in from the baked file, most recently
+ * used first, within a per-frame upload budget.
+ *
+ * Only baked (.ktx) textures can stream since only they can re-read one level without decoding the whole
+ * image. Everything else is counted at its full size and never evicted. Streamable textures never drop
+ * below the mip tail they were loaded with (kStartMipSize).
+ *
+ * A texture whose levels changed is recreated at the end of update() holding only its resident levels
+ * (Texture::applyLevels), so residentBytes is what the GL objects were allocated with rather than a
+ * hope that the driver trims a level in place. The recreated textures get new names, see getRenamedTextures().
+ */
+class TextureResidency
+{
+public:
+    // Baked textures are loaded with only the levels at most this big, the rest stream in on demand
+    static constexpr int kStartMipSize = 128;
+    static constexpr uint32_t kEvictAfterFrames = 120;
+    // Levels sharper than the projected size asks for, surfaces usually tile their texture more than once
+    static constexpr float kDetailBias = 1.0f;
+
+    void add(Texture* texture);
+    void clear();
+
+    void setBudget(size_t budgetBytes) { m_stats.budgetBytes = budgetBytes; }
+    [[nodiscard]] size_t getBudget() const { return m_stats.budgetBytes; }
+
+    // Off: new textures load every level and update() leaves them alone (deterministic benchmarks)
+    void setMipStreaming(bool streaming) { m_streaming = streaming; }
+    [[nodiscard]] bool isMipStreaming() const { return m_streaming; }
+    [[nodiscard]] int getStartMipSize() const { return m_streaming ? kStartMipSize : 0; }
+
+    // Renderer, per draw. screenPixels is the surface's projected size along its longest side.
+    void markUsed(GLuint textureID, float screenPixels);
+
+    // GL thread, once per frame before rendering
+    void update(size_t uploadByteBudget);
+
+    [[nodiscard]] const TextureResidencyStats& getStats() const { return m_stats; }
+    // Textures recreated by the last update(), materials must be patched before the next draw
+    [[nodiscard]] const std::vector<TextureRename>& getRenamedTextures() const { return m_renamed; }
+
+private:
+    struct Entry
+    {
+        Texture* texture;
+        int minLevel;            // the tail it was loaded with, never evicted past
+        int wantedLevel;
+        uint64_t lastUsedFrame = 0;
+        float screenPixels = 0.0f;  // largest reported since the last update()
+    };
+
+    int getWantedLevel(const Entry& entry) const;
+    size_t evictLevel(Entry& entry);
+    // Evicts from entries last drawn before frame until bytes more fit in the budget
+    bool makeRoom(size_t bytes, uint64_t frame);
+
+    std::vector<Entry> m_entries;
+    std::unordered_map<GLuint, size_t> m_entryByID;
+    std::vector<size_t> m_order;   // scratch for sorting entries
+    std::vector<TextureRename> m_renamed;
+    uint64_t m_frame = 1;
+    bool m_streaming = true;
+    TextureResidencyStats m_stats;
+};
+
+#endif //TEXTURERESIDENCY_H
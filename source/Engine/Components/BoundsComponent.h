@@ -0,0 +1,48 @@
+//
+// Created by Shaun on 17/10/2026.
+//
+
+#ifndef BOUNDSCOMPONENT_H
+#define BOUNDSCOMPONENT_H
+
+#include <algorithm>
+#include <cmath>
+#include <glm/glm.hpp>
+
+struct BoundsComponent {
+    // Object space, computed once at import
+    glm::vec3 localMin = glm::vec3(0.0f);
+    glm::vec3 localMax = glm::vec3(0.0f);
+    glm::vec3 localCenter = glm::vec3(0.0f);                                        // Bounding sphere centre
+    float localRadius = 0.0f;
+
+    // World space AABB, rebuilt by Scene::updateWorldMatrices() whenever the world matrix changes
+    glm::vec3 worldCenter = glm::vec3(0.0f);
+    glm::vec3 worldExtents = glm::vec3(0.0f);
+    float worldRadius = 0.0f;
+
+    BoundsComponent() = default;
+
+    BoundsComponent(const glm::vec3& min, const glm::vec3& max)
+        : localMin(min),
+          localMax(max),
+          localCenter((min + max) * 0.5f),
+          localRadius(glm::length(max - min) * 0.5f) {}
+
+    void updateWorld(const glm::mat4& model) {
+        const glm::vec3 localExtents = (localMax - localMin) * 0.5f;
+
+        // Arvo: the world extents along each axis are the local extents dotted with |row| of the rotation/scale
+        worldCenter = glm::vec3(model * glm::vec4(localCenter, 1.0f));
+        for (int axis = 0; axis < 3; axis++) {
+            worldExtents[axis] = std::abs(model[0][axis]) * localExtents.x +
+                                 std::abs(model[1][axis]) * localExtents.y +
+                                 std::abs(model[2][axis]) * localExtents.z;
+        }
+        float maxScale = std::max(glm::length(glm::vec3(model[0])),
+                                  std::max(glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2]))));
+        worldRadius = localRadius * maxScale;
+    }
+};
+
+#endif //BOUNDSCOMPONENT_H
@@ -20,6 +20,7 @@ struct MaterialComponent
     GLuint normalTextureID = 0; // Normal map
 
     bool isDecal = false;
+    bool alphaTested = false;
 
     MaterialComponent() = default;
 
@@ -30,7 +31,8 @@ struct MaterialComponent
             metalnessTextureID(materialData.metalnessTextureID),
             roughnessTextureID(materialData.roughnessTextureID),
             normalTextureID(materialData.normalTextureID),
-            isDecal(materialData.isDecal)
+            isDecal(materialData.isDecal),
+            alphaTested(materialData.alphaTested)
     {
     }
 };
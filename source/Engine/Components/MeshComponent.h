@@ -9,13 +9,19 @@
 
 
 struct MeshComponent {
+    // CPU copies, only populated until the mesh has been uploaded to the GeometryArena
     std::vector<Vertex> vertices;
     std::vector<unsigned int> indices;
 
-    unsigned int vao = 0;                                                           // Vertex Array Object ID
-    unsigned int vbo = 0;                                                           // Vertex Buffer Object ID
-    unsigned int ebo = 0;
+    unsigned int vao = 0;                                                           // GeometryArena page VAO (shared)
+    int baseVertex = 0;                                                             // First vertex of this mesh in the page VBO
+    unsigned int firstIndex = 0;                                                    // First index of this mesh in the page EBO
     size_t indexCount = 0;
+    // Undoes the position quantization of VertexFormat::Compact (identity for the full format)
+    glm::vec3 positionOffset = glm::vec3(0.0f);
+    glm::vec3 positionScale = glm::vec3(1.0f);
+
+    MeshComponent() = default;
 
     // Constructor to initialize from RawMeshData
     MeshComponent(const RawMeshData& rawMeshData)
@@ -23,6 +29,12 @@ struct MeshComponent {
           indices(rawMeshData.indices),
           indexCount(rawMeshData.indices.size()) {}
 
+    // Takes the raw geometry instead of copying it
+    MeshComponent(RawMeshData&& rawMeshData)
+        : vertices(std::move(rawMeshData.vertices)),
+          indices(std::move(rawMeshData.indices)),
+          indexCount(indices.size()) {}
+
 };
 
 #endif //MESHCOMPONENT_H
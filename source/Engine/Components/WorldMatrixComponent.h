@@ -0,0 +1,25 @@
+//
+// Created by Shaun on 17/10/2026.
+//
+
+#ifndef WORLDMATRIXCOMPONENT_H
+#define WORLDMATRIXCOMPONENT_H
+
+#include <glm/glm.hpp>
+
+// Cached model matrix. Renderers read this instead of calling TransformComponent::getModelMatrix().
+// Change transforms through registry.patch/replace<TransformComponent>() so the entry gets flagged dirty,
+// Scene::updateWorldMatrices() then rebuilds only the dirty ones.
+struct WorldMatrixComponent {
+    glm::mat4 matrix = glm::mat4(1.0f);
+    bool dirty = true;
+
+    WorldMatrixComponent() = default;
+
+    // Takes the imported node matrix as is, static meshes never go through the Euler decomposition
+    explicit WorldMatrixComponent(const glm::mat4& importedMatrix)
+        : matrix(importedMatrix),
+          dirty(false) {}
+};
+
+#endif //WORLDMATRIXCOMPONENT_H
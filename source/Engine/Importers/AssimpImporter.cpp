@@ -1,26 +1,42 @@
 #include "AssimpImporter.h"
 
+#include <chrono>
 #include <filesystem>
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
-#include <iostream>
 #include <TextureManager.h>
 #include <GL/glew.h> // Include OpenGL for VAO/VBO/EBO
 #include <glm/gtc/type_ptr.hpp>
 
+#include "MeshCache.h"
+#include "ThreadPool.h"
+#include "Logger.h"
+
+const unsigned int AssimpImporter::kImportFlags =
+    aiProcess_Triangulate |                         // Ensure all faces are triangles
+    aiProcess_FlipUVs |                             // Flip UVs to match the OpenGL texture coordinate space
+    aiProcess_CalcTangentSpace |                    // Calculate tangents for normal mapping
+    aiProcess_GenNormals |                          // Generate normals if not present
+    aiProcess_JoinIdenticalVertices;                // Remove redundant vertices
+
 // Materials are not being used here anymore, remove.
 bool AssimpImporter::loadModel(const std::string& filepath, std::vector<RawMeshData>& meshes/*, std::vector<RawMaterialData>& materials*/) {
+    // Warm start: the cache holds everything Assimp would have produced, only the texture IDs need resolving
+    if (m_useMeshCache && MeshCache::load(filepath, kImportFlags, m_meshOptimization, meshes)) {
+        for (auto& mesh : meshes) {
+            resolveMaterialTextures(mesh.material);
+        }
+        m_loadedFromCache = true;
+        return true;
+    }
+    m_loadedFromCache = false;
+
     Assimp::Importer importer;
-    const aiScene* scene = importer.ReadFile(filepath,
-        aiProcess_Triangulate |                         // Ensure all faces are triangles
-        aiProcess_FlipUVs |                             // Flip UVs to match the OpenGL texture coordinate space
-        aiProcess_CalcTangentSpace |                    // Calculate tangents for normal mapping
-        aiProcess_GenNormals |                          // Generate normals if not present
-        aiProcess_JoinIdenticalVertices);               // Remove redundant vertices
+    const aiScene* scene = importer.ReadFile(filepath, kImportFlags);
 
     if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
-        std::cerr << "ERROR::ASSIMP::" << importer.GetErrorString() << std::endl;
+        LOG_ERROR(Import, "Assimp: " << importer.GetErrorString());
         return false;
     }
 
@@ -28,7 +44,17 @@ bool AssimpImporter::loadModel(const std::string& filepath, std::vector<RawMeshD
     // successive calls will multiply the parent transform with the current node's transform
     // in other words - each child mesh will transform relative to its parent
     glm::mat4 identity = glm::mat4(1.0f);
-    processNode(scene->mRootNode, scene, identity, meshes, /*materials, */filepath); // NOTE: Materials are not being used here anymore, remove.
+    if (m_parallelImport) {
+        processScene(scene, identity, meshes, filepath);
+    } else {
+        processNode(scene->mRootNode, scene, identity, meshes, /*materials, */filepath); // NOTE: Materials are not being used here anymore, remove.
+    }
+
+    optimizeMeshes(meshes, filepath);
+
+    if (m_useMeshCache && !MeshCache::save(filepath, kImportFlags, m_meshOptimization, meshes)) {
+        LOG_WARNING(Import, "Mesh cache not written for: " << filepath);
+    }
 
     return true;
 }
@@ -59,12 +85,116 @@ void AssimpImporter::processNode(aiNode* node, const aiScene* scene, const glm::
     }
 }
 
+/*
+ * Two phase version of processNode that produces exactly the same output.
+ * Phase one walks the node tree in the same order as processNode and records (mesh index, global transform)
+ * jobs. Materials are then extracted serially because the TextureManager uploads to GL, and finally the
+ * aiMesh -> RawMeshData conversion runs across the thread pool straight into preallocated slots.
+ */
+void AssimpImporter::processScene(const aiScene* scene, const glm::mat4& rootTransform, std::vector<RawMeshData>& meshes, const std::string& filepath)
+{
+    std::vector<MeshJob> jobs;
+    jobs.reserve(scene->mNumMeshes);
+    collectMeshJobs(scene->mRootNode, rootTransform, jobs);
+
+    const size_t firstSlot = meshes.size();
+    meshes.resize(firstSlot + jobs.size());
+
+    // every mesh sharing a material gets the same RawMaterialData, so only extract each one once
+    std::vector<RawMaterialData> materials(scene->mNumMaterials);
+    std::vector<bool> materialExtracted(scene->mNumMaterials, false);
+    for (size_t i = 0; i < jobs.size(); i++) {
+        RawMeshData& meshData = meshes[firstSlot + i];
+        meshData.transform = jobs[i].transform;
+
+        unsigned int materialIndex = scene->mMeshes[jobs[i].meshIndex]->mMaterialIndex;
+        if (materialIndex < scene->mNumMaterials) {
+            if (!materialExtracted[materialIndex]) {
+                materials[materialIndex] = extractMaterialData(scene->mMaterials[materialIndex], scene, filepath);
+                materialExtracted[materialIndex] = true;
+            }
+            meshData.material = materials[materialIndex];
+        }
+    }
+
+    ThreadPool::getInstance().parallelFor(jobs.size(), [&](size_t i) {
+        convertMesh(scene->mMeshes[jobs[i].meshIndex], meshes[firstSlot + i]);
+    });
+}
+
+/*
+ * Reorders every mesh for the post-transform cache and vertex fetch before it is cached or uploaded.
+ * ACMR/ATVR are measured per mesh before and after and reported for the whole model, weighted by
+ * triangle and vertex count.
+ */
+void AssimpImporter::optimizeMeshes(std::vector<RawMeshData>& meshes, const std::string& filepath)
+{
+    if (m_meshOptimization == MeshOptimization::None || meshes.empty())
+        return;
+
+    using namespace std::chrono;
+    auto start = high_resolution_clock::now();
+
+    std::vector<VertexCacheStats> before(meshes.size()), after(meshes.size());
+    std::vector<size_t> vertexCounts(meshes.size());
+    ThreadPool::getInstance().parallelFor(meshes.size(), [&](size_t i) {
+        RawMeshData& mesh = meshes[i];
+        before[i] = MeshOptimizer::analyzeVertexCache(mesh.indices, mesh.vertices.size());
+        vertexCounts[i] = mesh.vertices.size();
+        MeshOptimizer::optimize(mesh, m_meshOptimization);
+        after[i] = MeshOptimizer::analyzeVertexCache(mesh.indices, mesh.vertices.size());
+    });
+
+    double triangles = 0.0, vertices = 0.0;
+    double acmrBefore = 0.0, acmrAfter = 0.0, atvrBefore = 0.0, atvrAfter = 0.0;
+    for (size_t i = 0; i < meshes.size(); i++) {
+        const double meshTriangles = static_cast<double>(meshes[i].indices.size() / 3);
+        const double meshVertices = static_cast<double>(vertexCounts[i]);
+        acmrBefore += before[i].acmr * meshTriangles;
+        acmrAfter += after[i].acmr * meshTriangles;
+        atvrBefore += before[i].atvr * meshVertices;
+        atvrAfter += after[i].atvr * meshVertices;
+        triangles += meshTriangles;
+        vertices += meshVertices;
+    }
+    if (triangles == 0.0 || vertices == 0.0)
+        return;
+
+    auto stop = high_resolution_clock::now();
+    LOG_INFO(Import, "Mesh optimization (" << (m_meshOptimization == MeshOptimization::VertexCacheAndOverdraw ? "vertex cache + overdraw" : "vertex cache")
+                  << "): ACMR " << acmrBefore / triangles << " -> " << acmrAfter / triangles
+                  << ", ATVR " << atvrBefore / vertices << " -> " << atvrAfter / vertices
+                  << " (cache size " << MeshOptimizer::kCacheSize << "), "
+                  << duration_cast<milliseconds>(stop - start).count() << " milliseconds\tname: " << filepath);
+}
+
+void AssimpImporter::collectMeshJobs(const aiNode* node, const glm::mat4& parentTransform, std::vector<MeshJob>& jobs)
+{
+    glm::mat4 nodeTransform = glm::transpose(glm::make_mat4(&node->mTransformation.a1));
+    glm::mat4 globalTransform = parentTransform * nodeTransform;
+
+    for (unsigned int i = 0; i < node->mNumMeshes; i++) {
+        jobs.push_back({node->mMeshes[i], globalTransform});
+    }
+
+    for (unsigned int i = 0; i < node->mNumChildren; i++) {
+        collectMeshJobs(node->mChildren[i], globalTransform, jobs);
+    }
+}
+
 RawMeshData AssimpImporter::processMesh(aiMesh* mesh, const aiScene* scene, const std::string& filepath) {
     RawMeshData meshData;
+    convertMesh(mesh, meshData);
+    return meshData; // No material is attached here.
+}
+
+void AssimpImporter::convertMesh(const aiMesh* mesh, RawMeshData& meshData) {
+    meshData.vertices.reserve(mesh->mNumVertices);
+    meshData.indices.reserve(static_cast<size_t>(mesh->mNumFaces) * 3); // faces are triangulated on import
 
     // Process vertices
     for (unsigned int i = 0; i < mesh->mNumVertices; i++) {
-        Vertex vertex;
+        Vertex vertex{}; // zeroed so meshes without tangents are still deterministic (cache, import comparison)
         vertex.position = glm::vec3(mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z);
         vertex.normal = glm::vec3(mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z);
 
@@ -88,62 +218,31 @@ RawMeshData AssimpImporter::processMesh(aiMesh* mesh, const aiScene* scene, cons
         meshData.vertices.push_back(vertex);
     }
 
+    // object space AABB, used for culling once the mesh is in the scene
+    if (!meshData.vertices.empty()) {
+        meshData.boundsMin = meshData.boundsMax = meshData.vertices[0].position;
+        for (const auto& vertex : meshData.vertices) {
+            meshData.boundsMin = glm::min(meshData.boundsMin, vertex.position);
+            meshData.boundsMax = glm::max(meshData.boundsMax, vertex.position);
+        }
+    }
+
     // Process indices
     for (unsigned int i = 0; i < mesh->mNumFaces; i++) {
-        aiFace face = mesh->mFaces[i];
+        const aiFace& face = mesh->mFaces[i];
         for (unsigned int j = 0; j < face.mNumIndices; j++) {
             meshData.indices.push_back(face.mIndices[j]);
         }
     }
-
-    return meshData; // No material is attached here.
 }
 
-void AssimpImporter::setupMesh(MeshComponent& meshComponent) {
-    // Generate and bind VAO
-    glGenVertexArrays(1, &meshComponent.vao);
-    glGenBuffers(1, &meshComponent.vbo);
-    glGenBuffers(1, &meshComponent.ebo);
-
-    glBindVertexArray(meshComponent.vao);
-
-    // Upload vertex data to the GPU
-    glBindBuffer(GL_ARRAY_BUFFER, meshComponent.vbo);
-    glBufferData(GL_ARRAY_BUFFER, meshComponent.vertices.size() * sizeof(Vertex), meshComponent.vertices.data(), GL_STATIC_DRAW);
-
-    // Upload index data to the GPU
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, meshComponent.ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, meshComponent.indices.size() * sizeof(unsigned int), meshComponent.indices.data(), GL_STATIC_DRAW);
+void AssimpImporter::setupMesh(MeshComponent& meshComponent, GeometryArena& geometryArena) {
+    // Append to the shared vertex/index buffers instead of creating a VAO/VBO/EBO per mesh
+    geometryArena.upload(meshComponent.vertices, meshComponent.indices, meshComponent);
 
-    // Set vertex attribute pointers
-    /*
-     * Vertex array will look something like this
-     * --------------------------------------------------------
-     * | Position | Normal | TexCoords | Tangent | Bi-tangent |
-     * --------------------------------------------------------
-     * |   0      |   1    |     2     |    3    |     4      |
-     * --------------------------------------------------------
-     */
-    glEnableVertexAttribArray(0); // Position
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
-
-    glEnableVertexAttribArray(1); // Normal
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
-
-    glEnableVertexAttribArray(2); // TexCoords
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, texCoords));
-
-    glEnableVertexAttribArray(3); // Tangent
-    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, tangent));
-
-    glEnableVertexAttribArray(4); // Bi-tangent
-    glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, bitangent));
-
-    // Unbind VAO
-    glBindVertexArray(0);
-
-    // Set the index count
-    meshComponent.indexCount = meshComponent.indices.size();
+    // The GPU owns the geometry now, drop the CPU copies
+    std::vector<Vertex>().swap(meshComponent.vertices);
+    std::vector<unsigned int>().swap(meshComponent.indices);
 }
 
 
@@ -152,7 +251,7 @@ RawMaterialData AssimpImporter::extractMaterialData(aiMaterial* material, const
     RawMaterialData materialData;
 
     // Helper lambda for handling both embedded and external textures
-    auto loadTexture = [&](aiTextureType type, GLuint& textureID) {
+    auto loadTexture = [&](aiTextureType type, TextureUsage usage, GLuint& textureID, std::string& resolvedTexturePath) {
         aiString path;
         if (material->GetTexture(type, 0, &path) == AI_SUCCESS) {
             std::string texturePath = path.C_Str();
@@ -167,6 +266,7 @@ RawMaterialData AssimpImporter::extractMaterialData(aiMaterial* material, const
                 }
 
                 if (texturePath[0] == '*') {
+                    resolvedTexturePath = texturePath;
                     // Handle embedded texture
                     int textureIndex = atoi(texturePath.c_str() + 1);
                     if (textureIndex >= 0 && textureIndex < scene->mNumTextures) {
@@ -176,28 +276,50 @@ RawMaterialData AssimpImporter::extractMaterialData(aiMaterial* material, const
                 } else {
                     // Handle external texture
                     std::string directory = modelFilePath.substr(0, modelFilePath.find_last_of("/\\"));
-                    std::string resolvedPath = directory + "/" + texturePath;
-                    textureID = TextureManager::getInstance().loadTexture(resolvedPath);
+                    resolvedTexturePath = directory + "/" + texturePath;
+                    textureID = TextureManager::getInstance().loadTexture(resolvedTexturePath, usage);
                 }
             }
         }
     };
 
     // BaseColor (Albedo)
-    loadTexture(aiTextureType_BASE_COLOR, materialData.baseColorTextureID);
+    loadTexture(aiTextureType_BASE_COLOR, TextureUsage::Color, materialData.baseColorTextureID, materialData.baseColorTexturePath);
 
     // Metalness
-    // loadTexture(aiTextureType_METALNESS, materialData.metalnessTextureID);
+    // loadTexture(aiTextureType_METALNESS, TextureUsage::Data, materialData.metalnessTextureID, materialData.metalnessTexturePath);
 
     // Roughness
-    loadTexture(aiTextureType_DIFFUSE_ROUGHNESS, materialData.roughnessTextureID);
+    loadTexture(aiTextureType_DIFFUSE_ROUGHNESS, TextureUsage::Data, materialData.roughnessTextureID, materialData.roughnessTexturePath);
 
     // Normal
-    loadTexture(aiTextureType_NORMALS, materialData.normalTextureID);
+    loadTexture(aiTextureType_NORMALS, TextureUsage::Normal, materialData.normalTextureID, materialData.normalTexturePath);
+
+    // Cutout materials: a separate opacity map (OBJ map_d, FBX) or glTF's MASK mode. Either way the
+    // shader tests the albedo alpha, which is where importers put the coverage for these formats
+    aiString alphaMode;
+    materialData.alphaTested = material->GetTextureCount(aiTextureType_OPACITY) > 0 ||
+                               (material->Get("$mat.gltf.alphaMode", 0, 0, alphaMode) == AI_SUCCESS &&
+                                std::string(alphaMode.C_Str()) == "MASK");
 
     return materialData;
 }
 
+void AssimpImporter::resolveMaterialTextures(RawMaterialData& material)
+{
+    // embedded textures never reach the cache, so every path here is a file on disk
+    auto resolve = [](const std::string& path, TextureUsage usage, GLuint& textureID) {
+        if (!path.empty()) {
+            textureID = TextureManager::getInstance().loadTexture(path, usage);
+        }
+    };
+
+    resolve(material.baseColorTexturePath, TextureUsage::Color, material.baseColorTextureID);
+    resolve(material.metalnessTexturePath, TextureUsage::Data, material.metalnessTextureID);
+    resolve(material.roughnessTexturePath, TextureUsage::Data, material.roughnessTextureID);
+    resolve(material.normalTexturePath, TextureUsage::Normal, material.normalTextureID);
+}
+
 
 void AssimpImporter::normalizeModelScale(std::vector<RawMeshData>& meshes, float targetSize) {
     glm::vec3 minBounds(std::numeric_limits<float>::max());
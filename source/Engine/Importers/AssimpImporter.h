@@ -11,6 +11,8 @@
 #include "MaterialData.h"
 #include "MeshData.h"
 #include "Components/MeshComponent.h"
+#include "GeometryArena.h"
+#include "MeshOptimizer.h"
 
 
 
@@ -20,17 +22,46 @@ public:
     AssimpImporter() = default;
     ~AssimpImporter() = default;
 
+    // Post-processing steps passed to Assimp, also part of the mesh cache key
+    static const unsigned int kImportFlags;
+
     // Load a model file and populate ModelData
     bool loadModel(const std::string& filepath, std::vector<RawMeshData>& meshes/*, std::vector<RawMaterialData>& materials*/);
 
-    void setupMesh(MeshComponent& meshComponent);
+    // Uploads the mesh into the arena and frees its CPU-side vertex/index copies
+    void setupMesh(MeshComponent& meshComponent, GeometryArena& geometryArena);
+
+    // When enabled (default) loadModel reads/writes "<model>.meshcache" and skips Assimp on a hit
+    void setUseMeshCache(bool useMeshCache) { m_useMeshCache = useMeshCache; }
+    [[nodiscard]] bool wasLoadedFromCache() const { return m_loadedFromCache; }
+
+    // When enabled (default) meshes are converted across the ThreadPool, otherwise the serial processNode walk is used
+    void setParallelImport(bool parallelImport) { m_parallelImport = parallelImport; }
+
+    // Triangle/vertex reordering applied to every mesh after conversion (default: vertex cache), part of the mesh cache key
+    void setMeshOptimization(MeshOptimization optimization) { m_meshOptimization = optimization; }
 private:
+    struct MeshJob {
+        unsigned int meshIndex;         // index into aiScene::mMeshes
+        glm::mat4 transform;            // node global transform
+    };
+
+    bool m_useMeshCache = true;
+    bool m_loadedFromCache = false;
+    bool m_parallelImport = true;
+    MeshOptimization m_meshOptimization = MeshOptimization::VertexCache;
+
     // Helper functions to process Assimp structures
     void processNode(aiNode* node, const aiScene* scene, const glm::mat4& parentTransform, std::vector<RawMeshData>& meshes/*, std::vector<RawMaterialData>& materials*/, const std::string& filepath);
     RawMeshData processMesh(aiMesh* mesh, const aiScene* scene, const std::string& filepath);
+    void processScene(const aiScene* scene, const glm::mat4& rootTransform, std::vector<RawMeshData>& meshes, const std::string& filepath);
+    void collectMeshJobs(const aiNode* node, const glm::mat4& parentTransform, std::vector<MeshJob>& jobs);
+    static void convertMesh(const aiMesh* mesh, RawMeshData& meshData);
     // RawMaterialData processMaterial(aiMaterial* material, const aiScene* scene, const std::string& modelFilePath);
     RawMaterialData extractMaterialData(aiMaterial* material, const aiScene* scene, const std::string& modelFilePath);
+    void resolveMaterialTextures(RawMaterialData& material);
     void normalizeModelScale(std::vector<RawMeshData>& meshes, float targetSize);
+    void optimizeMeshes(std::vector<RawMeshData>& meshes, const std::string& filepath);
 
 };
 
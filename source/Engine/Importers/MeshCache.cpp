@@ -0,0 +1,215 @@
+//
+// Created by Shaun on 17/10/2026.
+//
+
+#include "MeshCache.h"
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <ostream>
+
+#include "AtomicFile.h"
+#include "MappedFile.h"
+#include "Logger.h"
+
+/*
+ * File layout (little endian, no padding between fields):
+ *
+ * | magic "EMSH" | version | importFlags | optimization | sourceTimestamp | pathLength | path bytes | meshCount |
+ * then per mesh:
+ * | vertexCount | indexCount | transform (16 floats) | boundsMin, boundsMax (6 floats) | isDecal | alphaTested | 4 x (length, texture path bytes) |
+ * | vertices (vertexCount * sizeof(Vertex)) | indices (indexCount * uint32) |
+ */
+namespace
+{
+    constexpr char kMagic[4] = {'E', 'M', 'S', 'H'};
+    // counts, transform, bounds, flags and four empty texture paths: the smallest a mesh record can be
+    constexpr size_t kMinMeshRecordSize = sizeof(uint32_t) * 2 + sizeof(float) * 22 + 2 + sizeof(uint32_t) * 4;
+
+    class CacheWriter
+    {
+    public:
+        explicit CacheWriter(std::ostream& stream) : m_stream(stream) {}
+
+        template <typename T>
+        void write(const T& value) { m_stream.write(reinterpret_cast<const char*>(&value), sizeof(T)); }
+
+        void writeBytes(const void* data, size_t size) { m_stream.write(static_cast<const char*>(data), static_cast<std::streamsize>(size)); }
+
+        void writeString(const std::string& value)
+        {
+            write(static_cast<uint32_t>(value.size()));
+            writeBytes(value.data(), value.size());
+        }
+
+    private:
+        std::ostream& m_stream;
+    };
+
+    // Bounds-checked cursor over the mapped cache file
+    class CacheReader
+    {
+    public:
+        CacheReader(const unsigned char* data, size_t size) : m_data(data), m_size(size) {}
+
+        template <typename T>
+        bool read(T& value) { return readBytes(&value, sizeof(T)); }
+
+        bool readBytes(void* out, size_t size)
+        {
+            if (size > m_size - m_offset)
+                return false;
+            std::memcpy(out, m_data + m_offset, size);
+            m_offset += size;
+            return true;
+        }
+
+        // Bytes not consumed yet, counts read from the file are checked against this before anything is sized
+        [[nodiscard]] size_t remaining() const { return m_size - m_offset; }
+
+        bool readString(std::string& value)
+        {
+            uint32_t length = 0;
+            if (!read(length) || length > m_size - m_offset)
+                return false;
+            value.assign(reinterpret_cast<const char*>(m_data + m_offset), length);
+            m_offset += length;
+            return true;
+        }
+
+    private:
+        const unsigned char* m_data;
+        size_t m_size;
+        size_t m_offset = 0;
+    };
+}
+
+std::string MeshCache::getCachePath(const std::string& sourcePath)
+{
+    return sourcePath + ".meshcache";
+}
+
+bool MeshCache::getSourceTimestamp(const std::string& sourcePath, long long& timestamp)
+{
+    std::error_code error;
+    auto writeTime = std::filesystem::last_write_time(sourcePath, error);
+    if (error)
+        return false;
+    timestamp = static_cast<long long>(writeTime.time_since_epoch().count());
+    return true;
+}
+
+bool MeshCache::load(const std::string& sourcePath, unsigned int importFlags, MeshOptimization optimization,
+                     std::vector<RawMeshData>& meshes)
+{
+    long long sourceTimestamp = 0;
+    if (!getSourceTimestamp(sourcePath, sourceTimestamp))
+        return false;
+
+    MappedFile file(getCachePath(sourcePath));
+    if (!file.isOpen())
+        return false;
+
+    CacheReader reader(file.data(), file.size());
+
+    char magic[4];
+    uint32_t version = 0, flags = 0, meshCount = 0;
+    uint8_t cachedOptimization = 0;
+    int64_t timestamp = 0;
+    std::string cachedPath;
+    if (!reader.readBytes(magic, sizeof(magic)) || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0)
+        return false;
+    if (!reader.read(version) || version != kVersion)
+        return false;
+    if (!reader.read(flags) || flags != importFlags)
+        return false;
+    if (!reader.read(cachedOptimization) || cachedOptimization != static_cast<uint8_t>(optimization))
+        return false;
+    if (!reader.read(timestamp) || timestamp != sourceTimestamp)
+        return false;
+    if (!reader.readString(cachedPath) || cachedPath != sourcePath)
+        return false;
+    if (!reader.read(meshCount) || meshCount > reader.remaining() / kMinMeshRecordSize)
+        return false;
+
+    std::vector<RawMeshData> cachedMeshes(meshCount);
+    for (auto& mesh : cachedMeshes) {
+        uint32_t vertexCount = 0, indexCount = 0;
+        uint8_t isDecal = 0, alphaTested = 0;
+        if (!reader.read(vertexCount) || !reader.read(indexCount))
+            return false;
+        if (!reader.readBytes(&mesh.transform[0][0], sizeof(float) * 16))
+            return false;
+        if (!reader.readBytes(&mesh.boundsMin[0], sizeof(float) * 3) || !reader.readBytes(&mesh.boundsMax[0], sizeof(float) * 3))
+            return false;
+        if (!reader.read(isDecal) || !reader.read(alphaTested))
+            return false;
+        mesh.material.isDecal = isDecal != 0;
+        mesh.material.alphaTested = alphaTested != 0;
+
+        if (!reader.readString(mesh.material.baseColorTexturePath) ||
+            !reader.readString(mesh.material.metalnessTexturePath) ||
+            !reader.readString(mesh.material.roughnessTexturePath) ||
+            !reader.readString(mesh.material.normalTexturePath))
+            return false;
+
+        // a truncated or corrupt file is a cache miss, not a huge allocation
+        if (vertexCount > reader.remaining() / sizeof(Vertex) ||
+            indexCount > (reader.remaining() - vertexCount * sizeof(Vertex)) / sizeof(unsigned int))
+            return false;
+        mesh.vertices.resize(vertexCount);
+        mesh.indices.resize(indexCount);
+        if (!reader.readBytes(mesh.vertices.data(), vertexCount * sizeof(Vertex)) ||
+            !reader.readBytes(mesh.indices.data(), indexCount * sizeof(unsigned int)))
+            return false;
+    }
+
+    meshes = std::move(cachedMeshes);
+    return true;
+}
+
+bool MeshCache::save(const std::string& sourcePath, unsigned int importFlags, MeshOptimization optimization,
+                     const std::vector<RawMeshData>& meshes)
+{
+    long long sourceTimestamp = 0;
+    if (!getSourceTimestamp(sourcePath, sourceTimestamp))
+        return false;
+
+    // embedded textures can only be decoded from the aiScene, so models using them are never cached
+    for (const auto& mesh : meshes) {
+        const RawMaterialData& material = mesh.material;
+        for (const std::string* path : {&material.baseColorTexturePath, &material.metalnessTexturePath,
+                                        &material.roughnessTexturePath, &material.normalTexturePath}) {
+            if (!path->empty() && (*path)[0] == '*')
+                return false;
+        }
+    }
+
+    return writeFileAtomically(getCachePath(sourcePath), LogCategory::Import, [&](std::ostream& stream) {
+        CacheWriter writer(stream);
+        writer.writeBytes(kMagic, sizeof(kMagic));
+        writer.write(static_cast<uint32_t>(kVersion));
+        writer.write(static_cast<uint32_t>(importFlags));
+        writer.write(static_cast<uint8_t>(optimization));
+        writer.write(static_cast<int64_t>(sourceTimestamp));
+        writer.writeString(sourcePath);
+        writer.write(static_cast<uint32_t>(meshes.size()));
+
+        for (const auto& mesh : meshes) {
+            writer.write(static_cast<uint32_t>(mesh.vertices.size()));
+            writer.write(static_cast<uint32_t>(mesh.indices.size()));
+            writer.writeBytes(&mesh.transform[0][0], sizeof(float) * 16);
+            writer.writeBytes(&mesh.boundsMin[0], sizeof(float) * 3);
+            writer.writeBytes(&mesh.boundsMax[0], sizeof(float) * 3);
+            writer.write(static_cast<uint8_t>(mesh.material.isDecal ? 1 : 0));
+            writer.write(static_cast<uint8_t>(mesh.material.alphaTested ? 1 : 0));
+            writer.writeString(mesh.material.baseColorTexturePath);
+            writer.writeString(mesh.material.metalnessTexturePath);
+            writer.writeString(mesh.material.roughnessTexturePath);
+            writer.writeString(mesh.material.normalTexturePath);
+            writer.writeBytes(mesh.vertices.data(), mesh.vertices.size() * sizeof(Vertex));
+            writer.writeBytes(mesh.indices.data(), mesh.indices.size() * sizeof(unsigned int));
+        }
+    });
+}
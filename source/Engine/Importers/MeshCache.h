@@ -0,0 +1,43 @@
+//
+// Created by Shaun on 17/10/2026.
+//
+
+#ifndef MESHCACHE_H
+#define MESHCACHE_H
+
+#include <string>
+#include <vector>
+
+#include "MaterialData.h"
+#include "MeshData.h"
+#include "MeshOptimizer.h"
+
+/**
+ * @brief Versioned on-disk binary cache of imported RawMeshData.
+ *
+ * The cache sits next to the source model as "<model>.meshcache" and is keyed by the source path,
+ * its last write time, the importer flags and the mesh optimization used to produce it. Any mismatch is treated as a miss
+ * and the caller falls back to a full Assimp import (which then rewrites the cache).
+ *
+ * Texture IDs are not persisted - only the texture paths are, and the caller re-resolves them
+ * through the TextureManager after a hit.
+ */
+class MeshCache
+{
+public:
+    // Bump whenever the on-disk layout or the Vertex struct changes
+    static constexpr unsigned int kVersion = 4;
+
+    static std::string getCachePath(const std::string& sourcePath);
+
+    // Returns false on any miss (no file, stale, wrong version/flags, truncated)
+    static bool load(const std::string& sourcePath, unsigned int importFlags, MeshOptimization optimization,
+                     std::vector<RawMeshData>& meshes);
+    static bool save(const std::string& sourcePath, unsigned int importFlags, MeshOptimization optimization,
+                     const std::vector<RawMeshData>& meshes);
+
+private:
+    static bool getSourceTimestamp(const std::string& sourcePath, long long& timestamp);
+};
+
+#endif //MESHCACHE_H
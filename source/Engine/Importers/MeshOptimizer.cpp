@@ -0,0 +1,244 @@
+//
+// Created by Shaun on 17/10/2026.
+//
+
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <glm/glm.hpp>
+
+namespace
+{
+    constexpr unsigned int kNoVertex = 0xFFFFFFFFu;
+
+    // Triangles touching each vertex, stored compressed: vertex v owns triangles[offsets[v] .. offsets[v + 1])
+    struct TriangleAdjacency
+    {
+        std::vector<unsigned int> offsets;
+        std::vector<unsigned int> triangles;
+        std::vector<unsigned int> liveCounts; // triangles per vertex not emitted yet
+
+        TriangleAdjacency(const std::vector<unsigned int>& indices, size_t vertexCount)
+            : offsets(vertexCount + 1, 0), triangles(indices.size()), liveCounts(vertexCount, 0)
+        {
+            for (unsigned int index : indices)
+                liveCounts[index]++;
+            for (size_t v = 0; v < vertexCount; ++v)
+                offsets[v + 1] = offsets[v] + liveCounts[v];
+
+            std::vector<unsigned int> fill(offsets.begin(), offsets.end() - 1);
+            for (size_t i = 0; i < indices.size(); ++i)
+                triangles[fill[indices[i]]++] = static_cast<unsigned int>(i / 3);
+        }
+    };
+}
+
+void MeshOptimizer::optimize(RawMeshData& mesh, MeshOptimization optimization)
+{
+    // only triangle lists are handled, the importer triangulates everything
+    if (optimization == MeshOptimization::None || mesh.indices.empty() || mesh.indices.size() % 3 != 0)
+        return;
+
+    if (optimization == MeshOptimization::VertexCacheAndOverdraw) {
+        std::vector<size_t> clusterStarts;
+        optimizeVertexCache(mesh.indices, mesh.vertices.size(), &clusterStarts);
+        optimizeOverdraw(mesh.indices, mesh.vertices, clusterStarts);
+    } else {
+        optimizeVertexCache(mesh.indices, mesh.vertices.size());
+    }
+    optimizeVertexFetch(mesh.vertices, mesh.indices);
+}
+
+VertexCacheStats MeshOptimizer::analyzeVertexCache(const std::vector<unsigned int>& indices, size_t vertexCount,
+                                                   unsigned int cacheSize)
+{
+    VertexCacheStats stats;
+    if (indices.empty() || vertexCount == 0)
+        return stats;
+
+    // a vertex is still cached while fewer than cacheSize other vertices have been loaded since it was
+    std::vector<unsigned int> cacheTime(vertexCount, 0);
+    std::vector<bool> referenced(vertexCount, false);
+    unsigned int timestamp = cacheSize + 1;
+    size_t transformed = 0, uniqueVertices = 0;
+    for (unsigned int index : indices) {
+        if (timestamp - cacheTime[index] > cacheSize) {
+            cacheTime[index] = timestamp++;
+            transformed++;
+        }
+        if (!referenced[index]) {
+            referenced[index] = true;
+            uniqueVertices++;
+        }
+    }
+
+    stats.acmr = static_cast<float>(transformed) / static_cast<float>(indices.size() / 3);
+    stats.atvr = static_cast<float>(transformed) / static_cast<float>(uniqueVertices);
+    return stats;
+}
+
+void MeshOptimizer::optimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount,
+                                        std::vector<size_t>* clusterStarts)
+{
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0)
+        return;
+
+    TriangleAdjacency adjacency(indices, vertexCount);
+    std::vector<unsigned int> cacheTime(vertexCount, 0);
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<unsigned int> deadEnds;
+    std::vector<unsigned int> candidates;
+    std::vector<unsigned int> output;
+    output.reserve(indices.size());
+
+    unsigned int timestamp = kCacheSize + 1;
+    size_t scanCursor = 0;
+
+    auto isCached = [&](unsigned int vertex) { return timestamp - cacheTime[vertex] <= kCacheSize; };
+
+    // Nowhere to go from the last fan: most recently emitted vertex with work left, else the next one in order
+    auto skipDeadEnd = [&]() {
+        while (!deadEnds.empty()) {
+            const unsigned int vertex = deadEnds.back();
+            deadEnds.pop_back();
+            if (adjacency.liveCounts[vertex] > 0)
+                return vertex;
+        }
+        for (; scanCursor < vertexCount; ++scanCursor) {
+            if (adjacency.liveCounts[scanCursor] > 0)
+                return static_cast<unsigned int>(scanCursor);
+        }
+        return kNoVertex;
+    };
+
+    unsigned int fanVertex = indices[0];
+    bool clusterStart = true;
+    while (fanVertex != kNoVertex) {
+        if (clusterStart && clusterStarts)
+            clusterStarts->push_back(output.size());
+
+        // emit every remaining triangle around the fan vertex
+        candidates.clear();
+        for (unsigned int a = adjacency.offsets[fanVertex]; a < adjacency.offsets[fanVertex + 1]; ++a) {
+            const unsigned int triangle = adjacency.triangles[a];
+            if (emitted[triangle])
+                continue;
+            emitted[triangle] = true;
+
+            for (unsigned int corner = 0; corner < 3; ++corner) {
+                const unsigned int vertex = indices[triangle * 3 + corner];
+                output.push_back(vertex);
+                deadEnds.push_back(vertex);
+                candidates.push_back(vertex);
+                adjacency.liveCounts[vertex]--;
+                if (!isCached(vertex))
+                    cacheTime[vertex] = timestamp++;
+            }
+        }
+
+        // next fan: the oldest candidate that would still be cached after its own fan is emitted,
+        // otherwise any candidate with triangles left
+        unsigned int next = kNoVertex;
+        int bestPriority = -1;
+        for (unsigned int vertex : candidates) {
+            if (adjacency.liveCounts[vertex] == 0)
+                continue;
+            int priority = 0;
+            if (timestamp - cacheTime[vertex] + 2 * adjacency.liveCounts[vertex] <= kCacheSize)
+                priority = static_cast<int>(timestamp - cacheTime[vertex]);
+            if (priority > bestPriority) {
+                bestPriority = priority;
+                next = vertex;
+            }
+        }
+
+        clusterStart = false;
+        if (next == kNoVertex) {
+            next = skipDeadEnd();
+            // a jump to a vertex that has fallen out of the cache starts over cold, which is where
+            // clusters can be cut without costing anything extra
+            clusterStart = next != kNoVertex && !isCached(next);
+        }
+        fanVertex = next;
+    }
+
+    indices.swap(output);
+}
+
+void MeshOptimizer::optimizeOverdraw(std::vector<unsigned int>& indices, const std::vector<Vertex>& vertices,
+                                     const std::vector<size_t>& clusterStarts)
+{
+    if (clusterStarts.size() < 2)
+        return;
+
+    struct Cluster
+    {
+        size_t begin, end;
+        glm::vec3 centroid;
+        glm::vec3 normal;
+        float sortKey;
+    };
+
+    // area weighted centroid and normal of every cluster, and of the whole mesh
+    std::vector<Cluster> clusters(clusterStarts.size());
+    glm::vec3 meshCentroid(0.0f);
+    float meshArea = 0.0f;
+    for (size_t c = 0; c < clusters.size(); ++c) {
+        Cluster& cluster = clusters[c];
+        cluster.begin = clusterStarts[c];
+        cluster.end = c + 1 < clusterStarts.size() ? clusterStarts[c + 1] : indices.size();
+        cluster.centroid = glm::vec3(0.0f);
+        cluster.normal = glm::vec3(0.0f);
+
+        float area = 0.0f;
+        for (size_t i = cluster.begin; i < cluster.end; i += 3) {
+            const glm::vec3& p0 = vertices[indices[i]].position;
+            const glm::vec3& p1 = vertices[indices[i + 1]].position;
+            const glm::vec3& p2 = vertices[indices[i + 2]].position;
+            const glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+            const float triangleArea = glm::length(normal);
+            cluster.centroid += (p0 + p1 + p2) * (triangleArea / 3.0f);
+            cluster.normal += normal;
+            area += triangleArea;
+        }
+
+        meshCentroid += cluster.centroid;
+        meshArea += area;
+        if (area > 0.0f)
+            cluster.centroid /= area;
+    }
+    if (meshArea > 0.0f)
+        meshCentroid /= meshArea;
+
+    // clusters facing outwards from far out are the likely occluders, so they go first
+    for (Cluster& cluster : clusters) {
+        const float length = glm::length(cluster.normal);
+        cluster.sortKey = length > 0.0f ? glm::dot(cluster.centroid - meshCentroid, cluster.normal / length) : 0.0f;
+    }
+    std::stable_sort(clusters.begin(), clusters.end(),
+                     [](const Cluster& a, const Cluster& b) { return a.sortKey > b.sortKey; });
+
+    std::vector<unsigned int> sorted;
+    sorted.reserve(indices.size());
+    for (const Cluster& cluster : clusters)
+        sorted.insert(sorted.end(), indices.begin() + cluster.begin, indices.begin() + cluster.end);
+    indices.swap(sorted);
+}
+
+void MeshOptimizer::optimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices)
+{
+    std::vector<unsigned int> remap(vertices.size(), kNoVertex);
+    std::vector<Vertex> reordered;
+    reordered.reserve(vertices.size());
+
+    for (unsigned int& index : indices) {
+        if (remap[index] == kNoVertex) {
+            remap[index] = static_cast<unsigned int>(reordered.size());
+            reordered.push_back(vertices[index]);
+        }
+        index = remap[index];
+    }
+
+    vertices.swap(reordered);
+}
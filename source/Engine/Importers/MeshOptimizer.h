@@ -0,0 +1,66 @@
+//
+// Created by Shaun on 17/10/2026.
+//
+
+#ifndef MESHOPTIMIZER_H
+#define MESHOPTIMIZER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "MaterialData.h"
+#include "MeshData.h"
+
+// What the importer does to each mesh's triangle and vertex order after conversion
+enum class MeshOptimization : uint8_t
+{
+    None = 0,
+    VertexCache = 1,            // Tipsify triangle order + vertex fetch order
+    VertexCacheAndOverdraw = 2  // as above, then clusters sorted outside-in to cut overdraw
+};
+
+// Post-transform cache behaviour of an index buffer under a simulated FIFO cache
+struct VertexCacheStats
+{
+    float acmr = 0.0f; // vertices transformed per triangle (0.5 is the ideal for a large regular grid, 3 the worst)
+    float atvr = 0.0f; // vertices transformed per referenced vertex (1 is ideal)
+};
+
+/**
+ * @brief Reorders indexed triangle lists for the GPU's post-transform vertex cache and vertex fetch.
+ *
+ * The triangle order comes from Tipsify (Sander, Nehab, Barczak - "Fast Triangle Reordering for Vertex
+ * Locality and Reduced Overdraw", 2007): it fans around a vertex, then moves on to whichever of the
+ * vertices it just emitted is still in the cache and has triangles left. The points where it had to
+ * jump elsewhere split the output into clusters, which the overdraw pass can reorder without undoing
+ * the cache locality inside them. Vertices are then renumbered in first-use order so fetches walk
+ * the vertex buffer forwards.
+ *
+ * Everything is deterministic, so a cached result and a fresh import always agree.
+ */
+class MeshOptimizer
+{
+public:
+    // The FIFO size Tipsify targets and the statistics are measured with
+    static constexpr unsigned int kCacheSize = 16;
+
+    // Runs the passes selected by optimization over the mesh, its bounds are left as they were
+    static void optimize(RawMeshData& mesh, MeshOptimization optimization);
+
+    [[nodiscard]] static VertexCacheStats analyzeVertexCache(const std::vector<unsigned int>& indices, size_t vertexCount,
+                                                             unsigned int cacheSize = kCacheSize);
+
+    // Tipsify. clusterStarts receives the first index of every cluster (optional)
+    static void optimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount,
+                                    std::vector<size_t>* clusterStarts = nullptr);
+
+    // Sorts clusters so the ones facing away from the mesh centre (likely occluders) are drawn first
+    static void optimizeOverdraw(std::vector<unsigned int>& indices, const std::vector<Vertex>& vertices,
+                                 const std::vector<size_t>& clusterStarts);
+
+    // Renumbers vertices in the order the index buffer first uses them, unreferenced ones are dropped
+    static void optimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices);
+};
+
+#endif //MESHOPTIMIZER_H
@@ -11,6 +11,8 @@
 
 struct LoadedModel {
     std::vector<RawMeshData> meshes; // Raw mesh data
+    bool loadedFromCache = false;    // True when the binary mesh cache was hit instead of Assimp
+    double loadTimeMs = 0.0;
     // std::vector<RawMaterialData> materials; // Raw material data
 };
 
@@ -19,7 +21,17 @@ public:
     static ModelLoader& getInstance();
 
     // Load a model and return its raw data
-    LoadedModel loadModel(const std::string& filepath);
+    LoadedModel loadModel(const std::string& filepath, bool useMeshCache = true);
+
+    // Times a cold (Assimp + cache write) load against a warm (cache hit) load and prints both
+    void benchmarkLoad(const std::string& filepath);
+
+    // Imports the model serially and in parallel and checks both produce byte-identical meshes
+    bool verifyParallelImport(const std::string& filepath);
+
+    // Mesh optimization used by every import from now on (default: vertex cache)
+    void setMeshOptimization(MeshOptimization optimization) { m_meshOptimization = optimization; }
+    [[nodiscard]] MeshOptimization getMeshOptimization() const { return m_meshOptimization; }
 
 private:
     ModelLoader() = default;
@@ -27,6 +39,8 @@ private:
 
     ModelLoader(const ModelLoader&) = delete;
     ModelLoader& operator=(const ModelLoader&) = delete;
+
+    MeshOptimization m_meshOptimization = MeshOptimization::VertexCache;
 };
 
 #endif //MODELLOADER_H
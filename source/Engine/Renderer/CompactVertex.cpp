@@ -0,0 +1,82 @@
+//
+// Created by Shaun on 17/10/2026.
+//
+
+#include "CompactVertex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <glm/gtc/packing.hpp>
+
+namespace
+{
+    float signNotZero(float value) { return value >= 0.0f ? 1.0f : -1.0f; }
+
+    int16_t toSnorm16(float value)
+    {
+        return static_cast<int16_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+    }
+
+    uint16_t toUnorm16(float value)
+    {
+        return static_cast<uint16_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 65535.0f));
+    }
+}
+
+glm::vec2 CompactVertexPacking::octEncode(const glm::vec3& n)
+{
+    const float l1 = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+    if (l1 == 0.0f)
+        return glm::vec2(0.0f); // decodes to +Z rather than NaN
+
+    glm::vec2 e = glm::vec2(n.x, n.y) / l1;
+    // fold the lower hemisphere over the diagonals
+    if (n.z < 0.0f)
+        e = glm::vec2((1.0f - std::abs(e.y)) * signNotZero(e.x), (1.0f - std::abs(e.x)) * signNotZero(e.y));
+    return e;
+}
+
+void CompactVertexPacking::pack(const std::vector<Vertex>& vertices, std::vector<CompactVertex>& out,
+                                glm::vec3& positionOffset, glm::vec3& positionScale)
+{
+    out.resize(vertices.size());
+    positionOffset = glm::vec3(0.0f);
+    positionScale = glm::vec3(1.0f);
+    if (vertices.empty())
+        return;
+
+    glm::vec3 boundsMin = vertices[0].position;
+    glm::vec3 boundsMax = vertices[0].position;
+    for (const Vertex& vertex : vertices) {
+        boundsMin = glm::min(boundsMin, vertex.position);
+        boundsMax = glm::max(boundsMax, vertex.position);
+    }
+    // a flat axis keeps scale 0, every vertex then decodes to exactly the offset
+    positionOffset = boundsMin;
+    positionScale = boundsMax - boundsMin;
+
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        const Vertex& vertex = vertices[i];
+        CompactVertex& packed = out[i];
+
+        for (int axis = 0; axis < 3; ++axis) {
+            const float extent = positionScale[axis];
+            packed.position[axis] = extent > 0.0f ? toUnorm16((vertex.position[axis] - boundsMin[axis]) / extent) : 0;
+        }
+
+        // handedness of the tangent frame, the shader maps 0/1 back to -1/+1
+        const bool mirrored = glm::dot(glm::cross(vertex.normal, vertex.tangent), vertex.bitangent) < 0.0f;
+        packed.position[3] = mirrored ? 0 : 65535;
+
+        const glm::vec2 normal = octEncode(vertex.normal);
+        packed.normal[0] = toSnorm16(normal.x);
+        packed.normal[1] = toSnorm16(normal.y);
+
+        const glm::vec2 tangent = octEncode(vertex.tangent);
+        packed.tangent[0] = toSnorm16(tangent.x);
+        packed.tangent[1] = toSnorm16(tangent.y);
+
+        packed.texCoords[0] = glm::packHalf1x16(vertex.texCoords.x);
+        packed.texCoords[1] = glm::packHalf1x16(vertex.texCoords.y);
+    }
+}
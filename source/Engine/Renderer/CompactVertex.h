@@ -0,0 +1,58 @@
+//
+// Created by Shaun on 17/10/2026.
+//
+
+#ifndef COMPACTVERTEX_H
+#define COMPACTVERTEX_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "MaterialData.h"
+#include "MeshData.h"
+
+// How the GeometryArena stores vertices on the GPU, picked once at startup since every shader has to agree
+enum class VertexFormat : uint8_t
+{
+    Full = 0,   // Vertex as imported, 56 bytes
+    Compact = 1 // CompactVertex, 20 bytes
+};
+
+/*
+ * Quantized Vertex, decoded in the vertex shaders when they are built with COMPACT_VERTEX 1.
+ *
+ * | position xyz + bitangent sign (unorm16 x4) | normal (oct snorm16 x2) | tangent (oct snorm16 x2) | uv (half x2) |
+ * |                 0                          |           1            |            3             |      2       |
+ *
+ * Positions are relative to the mesh's bounds, the shader rebuilds them with the per-mesh offset/scale
+ * in MeshComponent. Normal and tangent are octahedral encoded, the bitangent is cross(normal, tangent)
+ * flipped by the sign in position.w, so mirrored UVs keep working.
+ */
+struct CompactVertex {
+    uint16_t position[4];
+    int16_t normal[2];
+    int16_t tangent[2];
+    uint16_t texCoords[2];
+};
+static_assert(sizeof(CompactVertex) == 20, "CompactVertex must match the attribute layout in GeometryArena");
+
+namespace CompactVertexPacking
+{
+    // Unit vector to the [-1, 1] square (Meyer et al. - "On Floating-Point Normal Vectors", 2010),
+    // undone by octDecode() in the vertex shaders
+    glm::vec2 octEncode(const glm::vec3& n);
+
+    // Quantizes vertices into out, positionOffset/positionScale receive what the shader needs to undo it
+    void pack(const std::vector<Vertex>& vertices, std::vector<CompactVertex>& out,
+              glm::vec3& positionOffset, glm::vec3& positionScale);
+
+    // Prepended to every program's defines when the scene uses the compact format
+    inline std::string shaderDefines(VertexFormat format)
+    {
+        return format == VertexFormat::Compact ? "#define COMPACT_VERTEX 1\n" : "";
+    }
+}
+
+#endif //COMPACTVERTEX_H
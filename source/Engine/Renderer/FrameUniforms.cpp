@@ -0,0 +1,85 @@
+//
+// Created by Shaun on 17/10/2026.
+//
+
+#include "FrameUniforms.h"
+
+#include "Camera.h"
+#include "Lights/DirectionalLight.h"
+
+FrameUniforms::FrameUniforms()
+{
+    m_cameraBuffer = CreateBuffer(UniformBinding::Camera, sizeof(CameraUniforms));
+    m_lightBuffer = CreateBuffer(UniformBinding::Light, sizeof(LightUniforms));
+    m_shadowBuffer = CreateBuffer(UniformBinding::Shadow, sizeof(ShadowUniforms));
+}
+
+FrameUniforms::~FrameUniforms()
+{
+    GLuint buffers[] = {m_cameraBuffer, m_lightBuffer, m_shadowBuffer};
+    glDeleteBuffers(3, buffers);
+}
+
+GLuint FrameUniforms::CreateBuffer(GLuint binding, size_t size)
+{
+    GLuint buffer = 0;
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+    glBufferData(GL_UNIFORM_BUFFER, static_cast<GLsizeiptr>(size), nullptr, GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, binding, buffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    return buffer;
+}
+
+void FrameUniforms::Update(const Camera& camera, const DirectionalLight& light, const ShadowMap& shadowMap)
+{
+    CameraUniforms cameraData{};
+    cameraData.view = camera.getViewMatrix();
+    cameraData.projection = camera.getProjectionMatrix();
+    cameraData.viewPos = camera.getPosition();
+
+    // position stays zero, the fragment shader only falls back to it when there is no direction
+    LightUniforms lightData{};
+    lightData.direction = light.getDirection();
+    lightData.ambient = light.getAmbient();
+    lightData.diffuse = light.getDiffuse();
+    lightData.specular = light.getSpecular();
+
+    ShadowUniforms shadowData{};
+    for (unsigned int i = 0; i < ShadowMap::kMaxCascades; i++) {
+        // unused cascades repeat the last one so an out of range index still samples something sane
+        const unsigned int cascade = i < shadowMap.GetCascadeCount() ? i : shadowMap.GetCascadeCount() - 1;
+        shadowData.cascadeMatrices[i] = shadowMap.GetCascadeMatrix(cascade);
+        shadowData.cascadeSplits[i] = shadowMap.GetCascadeSplit(cascade);
+    }
+    shadowData.mapSize = glm::vec2(static_cast<float>(shadowMap.GetResolution()));
+    shadowData.cascadeCount = static_cast<int>(shadowMap.GetCascadeCount());
+
+    glBindBuffer(GL_UNIFORM_BUFFER, m_cameraBuffer);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(cameraData), &cameraData);
+    glBindBuffer(GL_UNIFORM_BUFFER, m_lightBuffer);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(lightData), &lightData);
+    glBindBuffer(GL_UNIFORM_BUFFER, m_shadowBuffer);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(shadowData), &shadowData);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void FrameUniforms::BindBlocks(GLuint program)
+{
+    struct Block
+    {
+        const char* name;
+        GLuint binding;
+    };
+    static constexpr Block kBlocks[] = {
+        {"CameraBlock", UniformBinding::Camera},
+        {"LightBlock", UniformBinding::Light},
+        {"ShadowBlock", UniformBinding::Shadow},
+    };
+
+    for (const Block& block : kBlocks) {
+        GLuint index = glGetUniformBlockIndex(program, block.name);
+        if (index != GL_INVALID_INDEX)
+            glUniformBlockBinding(program, index, block.binding);
+    }
+}
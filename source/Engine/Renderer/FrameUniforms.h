@@ -0,0 +1,98 @@
+//
+// Created by Shaun on 17/10/2026.
+//
+
+#ifndef FRAMEUNIFORMS_H
+#define FRAMEUNIFORMS_H
+
+#include <cstddef>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "ShadowMap.h"
+
+class Camera;
+class DirectionalLight;
+
+// Fixed binding points for the per-frame uniform blocks, shared by every program that declares them
+namespace UniformBinding
+{
+    constexpr GLuint Camera = 0;
+    constexpr GLuint Light = 1;
+    constexpr GLuint Shadow = 2;
+}
+
+/*
+ * CPU mirrors of the std140 blocks declared in the shaders. A vec3 takes 16 bytes unless a scalar
+ * follows it, so the padding here has to match the GLSL declarations exactly:
+ *
+ * layout (std140) uniform CameraBlock { mat4 view; mat4 projection; vec3 viewPos; };
+ * layout (std140) uniform LightBlock { vec3 direction; vec3 position; vec3 ambient; vec3 diffuse; vec3 specular; } light;
+ * layout (std140) uniform ShadowBlock { mat4 cascadeMatrices[4]; vec4 cascadeSplits; vec2 gMapSize; int cascadeCount; };
+ */
+struct CameraUniforms
+{
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::vec3 viewPos;
+    float padding0;
+};
+
+struct LightUniforms
+{
+    glm::vec3 direction;
+    float padding0;
+    glm::vec3 position;
+    float padding1;
+    glm::vec3 ambient;
+    float padding2;
+    glm::vec3 diffuse;
+    float padding3;
+    glm::vec3 specular;
+    float padding4;
+};
+
+struct ShadowUniforms
+{
+    glm::mat4 cascadeMatrices[ShadowMap::kMaxCascades];
+    glm::vec4 cascadeSplits; // float[4] would get a 16 byte stride per element under std140
+    glm::vec2 mapSize;
+    int cascadeCount;
+    int padding0;
+};
+
+static_assert(sizeof(CameraUniforms) == 144, "CameraUniforms must match the std140 CameraBlock");
+static_assert(sizeof(LightUniforms) == 80, "LightUniforms must match the std140 LightBlock");
+static_assert(offsetof(ShadowUniforms, cascadeSplits) == 256 && sizeof(ShadowUniforms) == 288,
+              "ShadowUniforms must match the std140 ShadowBlock");
+
+/**
+ * @brief Per-frame uniform buffers for the camera, directional light and shadow cascades.
+ *
+ * Each block lives in its own UBO that stays bound to its UniformBinding point, and programs have their
+ * blocks pointed at those bindings once at link time (BindBlocks), so switching programs never needs the
+ * per-frame data re-uploading. Update() rewrites each buffer with one glBufferSubData call per frame.
+ */
+class FrameUniforms {
+public:
+    FrameUniforms();
+    ~FrameUniforms();
+
+    FrameUniforms(const FrameUniforms&) = delete;
+    FrameUniforms& operator=(const FrameUniforms&) = delete;
+
+    // Call after ShadowMap::UpdateCascades so the shadow block gets this frame's cascades
+    void Update(const Camera& camera, const DirectionalLight& light, const ShadowMap& shadowMap);
+
+    // Points any of the per-frame blocks the program declares at their fixed bindings
+    static void BindBlocks(GLuint program);
+
+private:
+    static GLuint CreateBuffer(GLuint binding, size_t size);
+
+    GLuint m_cameraBuffer = 0;
+    GLuint m_lightBuffer = 0;
+    GLuint m_shadowBuffer = 0;
+};
+
+#endif //FRAMEUNIFORMS_H
@@ -3,8 +3,8 @@
 //
 
 #include "Framebuffer.h"
+#include "Logger.h"
 
-#include <iostream>
 #include <GL/glew.h>
 
 namespace Carbon
@@ -32,7 +32,7 @@ namespace Carbon
         glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_renderBuffer);
 
         if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
-            std::cout << "ERROR::FRAMEBUFFER:: Framebuffer is not complete!" << std::endl;
+            LOG_ERROR(Renderer, "Framebuffer is not complete!");
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
     }
 
@@ -17,6 +17,7 @@ namespace Carbon
         void Unbind();
 
         unsigned int GetTextureColorBuffer() const { return m_textureColorBuffer; }
+        unsigned int GetHeight() const { return m_height; }
 
     private:
         unsigned int m_frameBuffer;
@@ -0,0 +1,117 @@
+//
+// Created by Shaun on 17/10/2026.
+//
+
+#include "FrustumCuller.h"
+
+#include <cmath>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define FRUSTUM_CULLER_SSE 1
+#endif
+
+#include "Components/BoundsComponent.h"
+
+void FrustumCuller::setFrustum(const glm::mat4& viewProjection, bool cullNearPlane)
+{
+    // Gribb/Hartmann: each plane is the last row of the matrix plus or minus one of the others
+    auto row = [&viewProjection](int i) {
+        return glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+    };
+    m_planes[0] = row(3) + row(0); // left
+    m_planes[1] = row(3) - row(0); // right
+    m_planes[2] = row(3) + row(1); // bottom
+    m_planes[3] = row(3) - row(1); // top
+    m_planes[4] = row(3) + row(2); // near
+    m_planes[5] = row(3) - row(2); // far
+
+    for (auto& plane : m_planes) {
+        plane /= glm::length(glm::vec3(plane));
+    }
+
+    if (!cullNearPlane)
+        m_planes[4] = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f); // every point is 1 unit in front of this one
+}
+
+void FrustumCuller::update(entt::registry& registry)
+{
+    m_entities.clear();
+    m_centerX.clear(); m_centerY.clear(); m_centerZ.clear();
+    m_extentX.clear(); m_extentY.clear(); m_extentZ.clear();
+
+    auto view = registry.view<BoundsComponent>();
+    for (auto entity : view) {
+        const auto& bounds = view.get<BoundsComponent>(entity);
+        m_entities.push_back(entity);
+        m_centerX.push_back(bounds.worldCenter.x);
+        m_centerY.push_back(bounds.worldCenter.y);
+        m_centerZ.push_back(bounds.worldCenter.z);
+        m_extentX.push_back(bounds.worldExtents.x);
+        m_extentY.push_back(bounds.worldExtents.y);
+        m_extentZ.push_back(bounds.worldExtents.z);
+    }
+}
+
+/*
+ * An AABB is outside a plane when its centre is further behind the plane than its projected radius,
+ * dot(n, c) + d < -(|n.x| * e.x + |n.y| * e.y + |n.z| * e.z). The box is culled if that holds for any plane.
+ * This is conservative, boxes straddling two planes outside a corner are kept.
+ */
+void FrustumCuller::cull()
+{
+    m_visible.clear();
+    const size_t count = m_entities.size();
+    size_t i = 0;
+
+#ifdef FRUSTUM_CULLER_SSE
+    __m128 planeX[6], planeY[6], planeZ[6], planeD[6], absX[6], absY[6], absZ[6];
+    for (int p = 0; p < 6; p++) {
+        planeX[p] = _mm_set1_ps(m_planes[p].x);
+        planeY[p] = _mm_set1_ps(m_planes[p].y);
+        planeZ[p] = _mm_set1_ps(m_planes[p].z);
+        planeD[p] = _mm_set1_ps(m_planes[p].w);
+        absX[p] = _mm_set1_ps(std::abs(m_planes[p].x));
+        absY[p] = _mm_set1_ps(std::abs(m_planes[p].y));
+        absZ[p] = _mm_set1_ps(std::abs(m_planes[p].z));
+    }
+
+    for (; i + 4 <= count; i += 4) {
+        const __m128 cx = _mm_loadu_ps(&m_centerX[i]);
+        const __m128 cy = _mm_loadu_ps(&m_centerY[i]);
+        const __m128 cz = _mm_loadu_ps(&m_centerZ[i]);
+        const __m128 ex = _mm_loadu_ps(&m_extentX[i]);
+        const __m128 ey = _mm_loadu_ps(&m_extentY[i]);
+        const __m128 ez = _mm_loadu_ps(&m_extentZ[i]);
+
+        __m128 outside = _mm_setzero_ps();
+        for (int p = 0; p < 6; p++) {
+            __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(planeX[p], cx), _mm_mul_ps(planeY[p], cy)),
+                                         _mm_add_ps(_mm_mul_ps(planeZ[p], cz), planeD[p]));
+            __m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(absX[p], ex), _mm_mul_ps(absY[p], ey)),
+                                       _mm_mul_ps(absZ[p], ez));
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), _mm_setzero_ps()));
+        }
+
+        const int outsideMask = _mm_movemask_ps(outside);
+        for (int lane = 0; lane < 4; lane++) {
+            if (!(outsideMask & (1 << lane)))
+                m_visible.push_back(m_entities[i + lane]);
+        }
+    }
+#endif
+
+    // scalar tail (or everything, without SSE)
+    for (; i < count; i++) {
+        bool outside = false;
+        for (int p = 0; p < 6 && !outside; p++) {
+            const glm::vec4& plane = m_planes[p];
+            float distance = plane.x * m_centerX[i] + plane.y * m_centerY[i] + plane.z * m_centerZ[i] + plane.w;
+            float radius = std::abs(plane.x) * m_extentX[i] + std::abs(plane.y) * m_extentY[i] +
+                           std::abs(plane.z) * m_extentZ[i];
+            outside = distance + radius < 0.0f;
+        }
+        if (!outside)
+            m_visible.push_back(m_entities[i]);
+    }
+}
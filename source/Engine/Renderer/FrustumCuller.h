@@ -0,0 +1,45 @@
+//
+// Created by Shaun on 17/10/2026.
+//
+
+#ifndef FRUSTUMCULLER_H
+#define FRUSTUMCULLER_H
+
+#include <cstdint>
+#include <vector>
+#include <entt/entt.hpp>
+#include <glm/glm.hpp>
+
+/**
+ * @brief Culls entities against a view frustum before anything is submitted.
+ *
+ * update() packs every BoundsComponent's world AABB (kept current by Scene::updateWorldMatrices())
+ * into structure-of-arrays float streams. cull() then tests them against the six
+ * frustum planes four at a time with SSE, falling back to scalar code on targets without it.
+ */
+class FrustumCuller
+{
+public:
+    // Extracts the planes from a projection * view matrix. Shadow casters pass cullNearPlane = false,
+    // objects between the light and the volume still throw shadows into it.
+    void setFrustum(const glm::mat4& viewProjection, bool cullNearPlane = true);
+
+    void update(entt::registry& registry);
+    void cull();
+
+    // Entities that passed, in registry view order
+    [[nodiscard]] const std::vector<entt::entity>& getVisibleEntities() const { return m_visible; }
+    [[nodiscard]] size_t getTestedCount() const { return m_entities.size(); }
+    [[nodiscard]] size_t getCulledCount() const { return m_entities.size() - m_visible.size(); }
+
+private:
+    glm::vec4 m_planes[6] = {};
+
+    std::vector<entt::entity> m_entities;
+    std::vector<float> m_centerX, m_centerY, m_centerZ;
+    std::vector<float> m_extentX, m_extentY, m_extentZ;
+
+    std::vector<entt::entity> m_visible;
+};
+
+#endif //FRUSTUMCULLER_H
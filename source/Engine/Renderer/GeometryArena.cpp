@@ -0,0 +1,175 @@
+//
+// Created by Shaun on 17/10/2026.
+//
+
+#include "GeometryArena.h"
+
+#include <algorithm>
+#include <cstddef>
+
+GeometryArena::GeometryArena(VertexFormat format)
+    : m_format(format), m_vertexStride(format == VertexFormat::Compact ? sizeof(CompactVertex) : sizeof(Vertex))
+{
+}
+
+GeometryArena::~GeometryArena()
+{
+    for (auto& page : m_pages) {
+        glDeleteVertexArrays(1, &page.vao);
+        glDeleteBuffers(1, &page.vbo);
+        glDeleteBuffers(1, &page.ebo);
+    }
+    glDeleteBuffers(1, &m_drawIdBuffer);
+}
+
+void GeometryArena::reserve(size_t vertexCount, size_t indexCount)
+{
+    if (!m_pages.empty()) {
+        const Page& page = m_pages.back();
+        if (page.vertexCount + vertexCount <= page.vertexCapacity && page.indexCount + indexCount <= page.indexCapacity)
+            return;
+    }
+    createPage(std::max(vertexCount, kDefaultPageVertices), std::max(indexCount, kDefaultPageIndices));
+}
+
+void GeometryArena::upload(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, MeshComponent& meshComponent)
+{
+    reserve(vertices.size(), indices.size());
+    Page& page = m_pages.back();
+
+    // the EBO binding is VAO state, so bind the page's VAO rather than touching whatever is current
+    glBindVertexArray(page.vao);
+
+    glBindBuffer(GL_ARRAY_BUFFER, page.vbo);
+    if (m_format == VertexFormat::Compact) {
+        CompactVertexPacking::pack(vertices, m_packed, meshComponent.positionOffset, meshComponent.positionScale);
+        glBufferSubData(GL_ARRAY_BUFFER, page.vertexCount * m_vertexStride, m_packed.size() * m_vertexStride, m_packed.data());
+    } else {
+        glBufferSubData(GL_ARRAY_BUFFER, page.vertexCount * m_vertexStride, vertices.size() * m_vertexStride, vertices.data());
+    }
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, page.ebo);
+    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, page.indexCount * sizeof(unsigned int), indices.size() * sizeof(unsigned int), indices.data());
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // indices stay mesh-local, baseVertex is added by glDrawElementsBaseVertex
+    meshComponent.vao = page.vao;
+    meshComponent.baseVertex = static_cast<GLint>(page.vertexCount);
+    meshComponent.firstIndex = static_cast<unsigned int>(page.indexCount);
+    meshComponent.indexCount = indices.size();
+
+    page.vertexCount += vertices.size();
+    page.indexCount += indices.size();
+}
+
+size_t GeometryArena::getVertexCount() const
+{
+    size_t count = 0;
+    for (const auto& page : m_pages)
+        count += page.vertexCount;
+    return count;
+}
+
+size_t GeometryArena::getIndexCount() const
+{
+    size_t count = 0;
+    for (const auto& page : m_pages)
+        count += page.indexCount;
+    return count;
+}
+
+void GeometryArena::createPage(size_t vertexCapacity, size_t indexCapacity)
+{
+    Page page;
+    page.vertexCapacity = vertexCapacity;
+    page.indexCapacity = indexCapacity;
+
+    glGenVertexArrays(1, &page.vao);
+    glGenBuffers(1, &page.vbo);
+    glGenBuffers(1, &page.ebo);
+
+    glBindVertexArray(page.vao);
+
+    glBindBuffer(GL_ARRAY_BUFFER, page.vbo);
+    glBufferData(GL_ARRAY_BUFFER, vertexCapacity * m_vertexStride, nullptr, GL_STATIC_DRAW);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, page.ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCapacity * sizeof(unsigned int), nullptr, GL_STATIC_DRAW);
+
+    if (m_format == VertexFormat::Compact)
+        setupCompactAttributes();
+    else
+        setupFullAttributes();
+
+    // Draw ID, one value per instance. Ignored by the regular shaders.
+    if (m_drawIdBuffer == 0) {
+        std::vector<GLuint> drawIds(kMaxDrawIDs);
+        for (size_t i = 0; i < kMaxDrawIDs; ++i)
+            drawIds[i] = static_cast<GLuint>(i);
+        glGenBuffers(1, &m_drawIdBuffer);
+        glBindBuffer(GL_ARRAY_BUFFER, m_drawIdBuffer);
+        glBufferData(GL_ARRAY_BUFFER, drawIds.size() * sizeof(GLuint), drawIds.data(), GL_STATIC_DRAW);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, m_drawIdBuffer);
+    glEnableVertexAttribArray(5);
+    glVertexAttribIPointer(5, 1, GL_UNSIGNED_INT, sizeof(GLuint), nullptr);
+    glVertexAttribDivisor(5, 1);
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    m_pages.push_back(page);
+}
+
+void GeometryArena::setupFullAttributes() const
+{
+    /*
+     * Vertex array will look something like this
+     * --------------------------------------------------------
+     * | Position | Normal | TexCoords | Tangent | Bi-tangent |
+     * --------------------------------------------------------
+     * |   0      |   1    |     2     |    3    |     4      |
+     * --------------------------------------------------------
+     */
+    glEnableVertexAttribArray(0); // Position
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
+
+    glEnableVertexAttribArray(1); // Normal
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
+
+    glEnableVertexAttribArray(2); // TexCoords
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, texCoords));
+
+    glEnableVertexAttribArray(3); // Tangent
+    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, tangent));
+
+    glEnableVertexAttribArray(4); // Bi-tangent
+    glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, bitangent));
+}
+
+void GeometryArena::setupCompactAttributes() const
+{
+    /*
+     * CompactVertex, decoded by the COMPACT_VERTEX path of the vertex shaders
+     * --------------------------------------------------------------------------
+     * | Position + bitangent sign | Oct normal | Half TexCoords | Oct tangent |
+     * --------------------------------------------------------------------------
+     * |            0              |     1      |       2        |      3      |
+     * --------------------------------------------------------------------------
+     */
+    glEnableVertexAttribArray(0); // Position in the mesh bounds, w = bitangent sign
+    glVertexAttribPointer(0, 4, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(CompactVertex), (void*)offsetof(CompactVertex, position));
+
+    glEnableVertexAttribArray(1); // Normal
+    glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, sizeof(CompactVertex), (void*)offsetof(CompactVertex, normal));
+
+    glEnableVertexAttribArray(2); // TexCoords
+    glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(CompactVertex), (void*)offsetof(CompactVertex, texCoords));
+
+    glEnableVertexAttribArray(3); // Tangent
+    glVertexAttribPointer(3, 2, GL_SHORT, GL_TRUE, sizeof(CompactVertex), (void*)offsetof(CompactVertex, tangent));
+
+    // no bitangent, the shader rebuilds it from the normal, tangent and sign
+}
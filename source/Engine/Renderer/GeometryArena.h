@@ -0,0 +1,80 @@
+//
+// Created by Shaun on 17/10/2026.
+//
+
+#ifndef GEOMETRYARENA_H
+#define GEOMETRYARENA_H
+
+#include <vector>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "MaterialData.h"
+#include "MeshData.h"
+#include "CompactVertex.h"
+#include "Components/MeshComponent.h"
+
+/**
+ * @brief Packs static meshes into a few large vertex/index buffers.
+ *
+ * Each page is one VAO with one VBO and one EBO. Meshes are appended to the current page and only
+ * remember where they live (baseVertex, firstIndex, indexCount), so the renderer can draw everything
+ * in a page with glDrawElementsBaseVertex without switching VAOs. Call reserve() with the totals of a
+ * model before uploading it so the whole model ends up in a single page.
+ *
+ * With VertexFormat::Compact the vertices are quantized to CompactVertex on upload and the meshes get
+ * the offset/scale their positions were packed with. The shaders have to be built to match.
+ */
+class GeometryArena {
+public:
+    explicit GeometryArena(VertexFormat format = VertexFormat::Full);
+    ~GeometryArena();
+
+    GeometryArena(const GeometryArena&) = delete;
+    GeometryArena& operator=(const GeometryArena&) = delete;
+
+    // Makes sure the current page can take this many more vertices/indices, opening a new page if not
+    void reserve(size_t vertexCount, size_t indexCount);
+
+    // Appends the mesh and fills in meshComponent's vao/baseVertex/firstIndex/indexCount (and position
+    // offset/scale in the compact format)
+    void upload(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, MeshComponent& meshComponent);
+
+    // Instanced attribute 5 reads gl_BaseInstance-offset values from this 0..N-1 buffer, which is how the
+    // multi-draw-indirect shaders get a draw ID on GL 4.3 without ARB_shader_draw_parameters
+    static constexpr size_t kMaxDrawIDs = 1 << 16;
+
+    [[nodiscard]] VertexFormat getVertexFormat() const { return m_format; }
+    [[nodiscard]] size_t getVertexStride() const { return m_vertexStride; }
+    [[nodiscard]] size_t getPageCount() const { return m_pages.size(); }
+    [[nodiscard]] size_t getVertexCount() const;
+    [[nodiscard]] size_t getIndexCount() const;
+
+private:
+    struct Page {
+        GLuint vao = 0;
+        GLuint vbo = 0;
+        GLuint ebo = 0;
+        size_t vertexCapacity = 0;
+        size_t indexCapacity = 0;
+        size_t vertexCount = 0;
+        size_t indexCount = 0;
+    };
+
+    // 1M vertices (56MB, 20MB compact) and 3M indices (12MB) unless a reservation asks for more
+    static constexpr size_t kDefaultPageVertices = 1 << 20;
+    static constexpr size_t kDefaultPageIndices = 3 << 20;
+
+    void createPage(size_t vertexCapacity, size_t indexCapacity);
+
+    void setupFullAttributes() const;
+    void setupCompactAttributes() const;
+
+    VertexFormat m_format;
+    size_t m_vertexStride;
+    std::vector<Page> m_pages;
+    GLuint m_drawIdBuffer = 0;
+    std::vector<CompactVertex> m_packed; // upload scratch for the compact format
+};
+
+#endif //GEOMETRYARENA_H
@@ -0,0 +1,51 @@
+//
+// Created by Shaun on 17/10/2026.
+//
+
+#include "IndirectDrawBuffer.h"
+
+IndirectDrawBuffer::IndirectDrawBuffer()
+{
+    glGenBuffers(1, &m_commandBuffer);
+    glGenBuffers(1, &m_drawDataBuffer);
+}
+
+IndirectDrawBuffer::~IndirectDrawBuffer()
+{
+    glDeleteBuffers(1, &m_commandBuffer);
+    glDeleteBuffers(1, &m_drawDataBuffer);
+}
+
+void IndirectDrawBuffer::clear()
+{
+    m_commands.clear();
+    m_drawData.clear();
+}
+
+void IndirectDrawBuffer::upload()
+{
+    // re-specifying the store each frame lets the driver hand us fresh memory instead of syncing with last frame
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer);
+    if (m_commands.size() > m_commandCapacity) {
+        m_commandCapacity = m_commands.size() * 2;
+    }
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, m_commandCapacity * sizeof(DrawElementsIndirectCommand), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, m_commands.size() * sizeof(DrawElementsIndirectCommand), m_commands.data());
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_drawDataBuffer);
+    if (m_drawData.size() > m_drawDataCapacity) {
+        m_drawDataCapacity = m_drawData.size() * 2;
+    }
+    glBufferData(GL_SHADER_STORAGE_BUFFER, m_drawDataCapacity * sizeof(IndirectDrawData), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, m_drawData.size() * sizeof(IndirectDrawData), m_drawData.data());
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, kDrawDataBinding, m_drawDataBuffer);
+}
+
+void IndirectDrawBuffer::draw(size_t first, size_t count) const
+{
+    glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT,
+                                reinterpret_cast<const void*>(first * sizeof(DrawElementsIndirectCommand)),
+                                static_cast<GLsizei>(count), 0);
+}
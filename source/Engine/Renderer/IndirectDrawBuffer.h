@@ -0,0 +1,64 @@
+//
+// Created by Shaun on 17/10/2026.
+//
+
+#ifndef INDIRECTDRAWBUFFER_H
+#define INDIRECTDRAWBUFFER_H
+
+#include <vector>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+// Layout fixed by glMultiDrawElementsIndirect
+struct DrawElementsIndirectCommand {
+    GLuint count;
+    GLuint instanceCount;
+    GLuint firstIndex;
+    GLint baseVertex;
+    GLuint baseInstance;        // used as the draw ID (see GeometryArena's draw ID attribute)
+};
+
+// Matches the std430 DrawData struct in the *_indirect vertex shaders
+struct IndirectDrawData {
+    glm::mat4 model;
+    glm::vec4 positionOffset;   // MeshComponent::positionOffset/positionScale, w unused
+    glm::vec4 positionScale;
+};
+
+/**
+ * @brief Per-frame command + per-draw data buffers for the multi-draw-indirect path (GL 4.3+).
+ *
+ * Fill commands()/drawData() on the CPU, call upload() once, then issue any number of
+ * glMultiDrawElementsIndirect calls over sub-ranges of the command buffer.
+ */
+class IndirectDrawBuffer {
+public:
+    static constexpr GLuint kDrawDataBinding = 0;   // SSBO binding point used by the shaders
+
+    IndirectDrawBuffer();
+    ~IndirectDrawBuffer();
+
+    IndirectDrawBuffer(const IndirectDrawBuffer&) = delete;
+    IndirectDrawBuffer& operator=(const IndirectDrawBuffer&) = delete;
+
+    void clear();
+    std::vector<DrawElementsIndirectCommand>& commands() { return m_commands; }
+    std::vector<IndirectDrawData>& drawData() { return m_drawData; }
+
+    // Orphans and refills both GPU buffers and binds them for drawing
+    void upload();
+
+    // Draws commands [first, first + count) - buffers must still be bound from upload()
+    void draw(size_t first, size_t count) const;
+
+private:
+    GLuint m_commandBuffer = 0;
+    GLuint m_drawDataBuffer = 0;
+    size_t m_commandCapacity = 0;
+    size_t m_drawDataCapacity = 0;
+
+    std::vector<DrawElementsIndirectCommand> m_commands;
+    std::vector<IndirectDrawData> m_drawData;
+};
+
+#endif //INDIRECTDRAWBUFFER_H
@@ -0,0 +1,184 @@
+//
+// Created by Shaun on 17/10/2026.
+//
+
+#include "RenderQueue.h"
+
+#include <cstring>
+
+#include "Shader.h"
+#include "Components/MaterialComponent.h"
+#include "Components/MeshComponent.h"
+
+void RenderStateTracker::invalidate()
+{
+    m_program = kUnknown;
+    m_vao = kUnknown;
+    for (auto& texture : m_textures)
+        texture = kUnknown;
+    m_activeUnit = -1;
+}
+
+void RenderStateTracker::invalidateProgram(GLuint program)
+{
+    for (size_t i = 0; i < m_samplers.size();) {
+        if (m_samplers[i].program == program) {
+            m_samplers[i] = m_samplers.back();
+            m_samplers.pop_back();
+        } else {
+            i++;
+        }
+    }
+    if (m_program == program)
+        m_program = kUnknown;
+}
+
+void RenderStateTracker::useProgram(GLuint program)
+{
+    if (program == m_program) {
+        m_skipped++;
+        return;
+    }
+    glUseProgram(program);
+    m_program = program;
+    m_issued++;
+}
+
+void RenderStateTracker::bindTexture(unsigned int unit, GLuint texture)
+{
+    if (unit < kMaxTextureUnits && m_textures[unit] == texture) {
+        m_skipped++;
+        return;
+    }
+    if (static_cast<int>(unit) != m_activeUnit) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        m_activeUnit = static_cast<int>(unit);
+    }
+    glBindTexture(GL_TEXTURE_2D, texture);
+    if (unit < kMaxTextureUnits)
+        m_textures[unit] = texture;
+    m_issued++;
+}
+
+void RenderStateTracker::bindVertexArray(GLuint vao)
+{
+    if (m_vao == vao) {
+        m_skipped++;
+        return;
+    }
+    glBindVertexArray(vao);
+    m_vao = vao;
+    m_issued++;
+}
+
+void RenderStateTracker::setSamplerUniform(const Shader& shader, UniformHandle<int> sampler, int unit)
+{
+    if (!sampler.isValid())
+        return;
+
+    const GLuint program = shader.GetShaderID();
+    for (auto& value : m_samplers) {
+        if (value.program == program && value.uniform == sampler.index) {
+            if (value.unit == unit) {
+                m_skipped++;
+                return;
+            }
+            value.unit = unit;
+            shader.SetUniform(sampler, unit);
+            m_issued++;
+            return;
+        }
+    }
+    m_samplers.push_back({program, sampler.index, unit});
+    shader.SetUniform(sampler, unit);
+    m_issued++;
+}
+
+void RenderQueue::clear()
+{
+    m_items.clear();
+    m_commands.clear();
+    // slots only have to agree within one sort. Keeping them would let programs from hot reloads and
+    // variants, and streamed texture sets, fill the slot space until everything shares the last slot
+    m_shaderSlots.clear();
+    m_materialSlots.clear();
+    m_vaoSlots.clear();
+}
+
+uint32_t RenderQueue::slotFor(std::unordered_map<uint64_t, uint32_t>& slots, uint64_t value, uint32_t maxSlot)
+{
+    auto it = slots.find(value);
+    if (it != slots.end())
+        return it->second;
+    // out of slots: everything else shares the last one, which only costs sort quality
+    uint32_t slot = slots.size() < maxSlot ? static_cast<uint32_t>(slots.size()) : maxSlot;
+    slots.emplace(value, slot);
+    return slot;
+}
+
+void RenderQueue::submit(RenderPass pass, Shader* shader, const MeshComponent& mesh, const MaterialComponent* material,
+                         const glm::mat4& model, float viewDepth)
+{
+    uint64_t textureSet = 0;
+    if (material) {
+        // the only textures the scene shaders sample, a GL name fits in 32 bits
+        textureSet = static_cast<uint64_t>(material->baseColorTextureID) << 32 |
+                     static_cast<uint64_t>(material->normalTextureID);
+    }
+
+    const uint64_t shaderSlot = slotFor(m_shaderSlots, shader->GetShaderID(), 0xFF);
+    const uint64_t materialSlot = slotFor(m_materialSlots, textureSet, 0xFFFF);
+    const uint64_t vaoSlot = slotFor(m_vaoSlots, mesh.vao, 0xFF);
+
+    // positive IEEE floats sort the same as their bit patterns, keep the top 24 bits
+    float depth = viewDepth > 0.0f ? viewDepth : 0.0f;
+    uint32_t depthBits;
+    std::memcpy(&depthBits, &depth, sizeof(depthBits));
+    const uint64_t depthKey = depthBits >> 7;
+
+    Command command;
+    command.key = (static_cast<uint64_t>(pass) & 0x3) << 62 |
+                  shaderSlot << 54 |
+                  materialSlot << 38 |
+                  vaoSlot << 30 |
+                  (depthKey & 0xFFFFFF) << 6;
+    command.itemIndex = static_cast<uint32_t>(m_items.size());
+
+    m_items.push_back({shader, &mesh, material, &model});
+    m_commands.push_back(command);
+}
+
+// LSD radix sort on 8 bit digits, skipping digits that are identical across every key
+void RenderQueue::sort()
+{
+    const size_t count = m_commands.size();
+    if (count < 2)
+        return;
+
+    m_scratch.resize(count);
+    Command* source = m_commands.data();
+    Command* destination = m_scratch.data();
+
+    for (int shift = 0; shift < 64; shift += 8) {
+        uint32_t histogram[256] = {};
+        for (size_t i = 0; i < count; i++)
+            histogram[(source[i].key >> shift) & 0xFF]++;
+
+        if (histogram[(source[0].key >> shift) & 0xFF] == count)
+            continue;
+
+        uint32_t offset = 0;
+        for (auto& bucket : histogram) {
+            uint32_t bucketCount = bucket;
+            bucket = offset;
+            offset += bucketCount;
+        }
+        for (size_t i = 0; i < count; i++)
+            destination[histogram[(source[i].key >> shift) & 0xFF]++] = source[i];
+
+        std::swap(source, destination);
+    }
+
+    if (source != m_commands.data())
+        std::memcpy(m_commands.data(), source, count * sizeof(Command));
+}
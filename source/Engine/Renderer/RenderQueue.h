@@ -0,0 +1,118 @@
+//
+// Created by Shaun on 17/10/2026.
+//
+
+#ifndef RENDERQUEUE_H
+#define RENDERQUEUE_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "Shader.h"
+
+struct MeshComponent;
+struct MaterialComponent;
+
+/**
+ * @brief Remembers the GL state the renderer last set and drops calls that would not change it.
+ *
+ * Covers glUseProgram, glBindTexture (per unit), glBindVertexArray and sampler uniform writes.
+ * Bindings are forgotten with invalidate() at the start of every pass because other code (ImGui,
+ * the framebuffer blit) changes them behind our back. Sampler uniforms live in the program object,
+ * so those are only forgotten when a program is relinked (invalidateProgram).
+ */
+class RenderStateTracker
+{
+public:
+    static constexpr unsigned int kMaxTextureUnits = 8;
+
+    void invalidate();
+    void invalidateProgram(GLuint program);
+
+    void useProgram(GLuint program);
+    void bindTexture(unsigned int unit, GLuint texture);
+    void bindVertexArray(GLuint vao);
+    void setSamplerUniform(const Shader& shader, UniformHandle<int> sampler, int unit);
+
+    [[nodiscard]] unsigned int getIssuedCount() const { return m_issued; }
+    [[nodiscard]] unsigned int getSkippedCount() const { return m_skipped; }
+    void resetCounters() { m_issued = 0; m_skipped = 0; }
+
+private:
+    struct SamplerValue
+    {
+        GLuint program;
+        int uniform; // UniformHandle index
+        int unit;
+    };
+
+    // never a real GL name, so the first call after invalidate() always goes through
+    static constexpr GLuint kUnknown = 0xFFFFFFFF;
+
+    GLuint m_program = kUnknown;
+    GLuint m_vao = kUnknown;
+    GLuint m_textures[kMaxTextureUnits] = {kUnknown, kUnknown, kUnknown, kUnknown,
+                                           kUnknown, kUnknown, kUnknown, kUnknown};
+    int m_activeUnit = -1;
+    std::vector<SamplerValue> m_samplers;
+
+    unsigned int m_issued = 0;
+    unsigned int m_skipped = 0;
+};
+
+enum class RenderPass : uint8_t
+{
+    Shadow = 0,
+    Opaque = 1
+};
+
+struct RenderItem
+{
+    Shader* shader;
+    const MeshComponent* mesh;
+    const MaterialComponent* material;   // nullptr for depth-only passes
+    const glm::mat4* model;              // points into the registry's WorldMatrixComponent storage
+};
+
+/**
+ * @brief Collects draws with a 64-bit sort key and radix sorts them.
+ *
+ * Key layout, most significant first:
+ * | pass (2) | shader (8) | material texture set (16) | arena VAO (8) | view depth (24) | unused (6) |
+ * so draws are grouped by the most expensive state first and go front to back within a group.
+ * Shaders, texture sets and VAOs are mapped to small dense slots when submitted, renumbered every clear().
+ */
+class RenderQueue
+{
+public:
+    void clear();
+    void submit(RenderPass pass, Shader* shader, const MeshComponent& mesh, const MaterialComponent* material,
+                const glm::mat4& model, float viewDepth);
+    void sort();
+
+    [[nodiscard]] size_t size() const { return m_commands.size(); }
+    // i-th draw in sorted order (only valid after sort())
+    [[nodiscard]] const RenderItem& operator[](size_t i) const { return m_items[m_commands[i].itemIndex]; }
+
+private:
+    struct Command
+    {
+        uint64_t key;
+        uint32_t itemIndex;
+    };
+
+    uint32_t slotFor(std::unordered_map<uint64_t, uint32_t>& slots, uint64_t value, uint32_t maxSlot);
+
+    std::vector<RenderItem> m_items;
+    std::vector<Command> m_commands;
+    std::vector<Command> m_scratch;
+
+    std::unordered_map<uint64_t, uint32_t> m_shaderSlots;
+    std::unordered_map<uint64_t, uint32_t> m_materialSlots;
+    std::unordered_map<uint64_t, uint32_t> m_vaoSlots;
+};
+
+#endif //RENDERQUEUE_H
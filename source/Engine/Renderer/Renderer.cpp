@@ -1,13 +1,18 @@
 #include "Renderer.h"
 #include <GL/glew.h>
-#include <iostream>
 #include <TextureManager.h>
 #include <glm/ext/matrix_transform.hpp>
+#include <algorithm>
+#include <limits>
+#include <tuple>
 
 #include "TextureLoader.h"
+#include "Profiler.h"
+#include "Components/BoundsComponent.h"
 #include "Components/MaterialComponent.h"
 #include "Components/MeshComponent.h"
-#include "Components/TransformComponent.h"
+#include "Components/WorldMatrixComponent.h"
+#include "Logger.h"
 
 
 Renderer::Renderer()
@@ -20,7 +25,14 @@ Renderer::Renderer()
     }
     else
     {
-        std::cerr << "Failed to load default texture." << std::endl;
+        LOG_ERROR(Renderer, "Failed to load default texture.");
+    }
+
+    // glMultiDrawElementsIndirect, SSBOs and baseInstance are all core in 4.3
+    m_indirectSupported = GLEW_VERSION_4_3;
+    if (m_indirectSupported)
+    {
+        m_indirectBuffer = std::make_unique<IndirectDrawBuffer>();
     }
 }
 
@@ -37,112 +49,205 @@ void Renderer::Clear() const
 
 void Renderer::Render(entt::registry& registry, ShaderManager& shaderManager, std::shared_ptr<Shader>& shadertest)
 {
+    ProfileScope profileScope("Main pass");
+
     glEnable(GL_CULL_FACE);
     glCullFace(GL_BACK);
 
-    // Iterate over entities with Mesh, Transform, and Material components
-    auto view = registry.view<MeshComponent, TransformComponent, MaterialComponent>();
-    for (auto entity : view) {
-        auto& mesh = registry.get<MeshComponent>(entity);
-        auto& transform = registry.get<TransformComponent>(entity);
-        auto& material = registry.get<MaterialComponent>(entity);
+    const std::vector<entt::entity>& entities = CollectVisibleEntities(registry);
 
-        auto shader = shaderManager.getShader(material.shaderID);
-        // essentially we just want to check if the currently bound shader is the same as the shader we want to use
-        if (shader->GetShaderID() != m_currentShaderID)
-        {
-            shader->Bind();
-            m_currentShaderID = shader->GetShaderID();
-        }
+    if (IsUsingIndirect() && RenderIndirect(registry, shaderManager, entities))
+        return;
 
-        glm::mat4 modelMatrix = transform.getModelMatrix();
-        shader->SetUniformMat4f("model", modelMatrix);
+    m_state.invalidate();
+    m_sceneUniforms = {};
+    m_queue.clear();
 
+    // Iterate over the entities that survived culling
+    for (auto entity : entities) {
+        auto& material = registry.get<MaterialComponent>(entity);
         // check for decals and enable transparency CURRENTLY JUST NOT RENDERING DECAL MESHES
-        if (!material.isDecal)
-        {
-            // if (!material.isDecal)
-            // {
-            //     glEnable(GL_BLEND);
-            //     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-            // } else
-            // {
-            //     glDisable(GL_BLEND);
-            // }
-
-            // Bind the diffuse texture
-            if (material.baseColorTextureID != 0) {
-                glActiveTexture(GL_TEXTURE0);
-                glBindTexture(GL_TEXTURE_2D, material.baseColorTextureID);
-                shader->SetUniform1i("albedoMap", 0);
-            } else {
-                defaultTexture->bind(0);
-                shader->SetUniform1i("albedoMap", 0);
-            }
-            if (material.normalTextureID != 0)
-            {
-                glActiveTexture(GL_TEXTURE1);
-                glBindTexture(GL_TEXTURE_2D, material.normalTextureID);
-                shader->SetUniform1i("normalMap", 1);
-            }
-            glActiveTexture(GL_TEXTURE2);
-            glBindTexture(GL_TEXTURE_2D, material.roughnessTextureID);
-            shader->SetUniform1i("roughnessMap", 2);
-
-
-            glBindVertexArray(mesh.vao);
-            glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(mesh.indexCount), GL_UNSIGNED_INT, nullptr);
-            glBindVertexArray(0);
-            // dont unbind the shader, since we are LIKELY to use it again
-        }
+        if (material.isDecal)
+            continue;
+
+        auto& mesh = registry.get<MeshComponent>(entity);
+        const glm::mat4& modelMatrix = registry.get<WorldMatrixComponent>(entity).matrix;
+        float viewDepth = glm::length(glm::vec3(modelMatrix[3]) - m_viewPosition);
+        ReportTextureUsage(registry, entity, material);
+        Shader* shader = shaderManager.getVariant(material.shaderID, GetMaterialVariant(material)).get();
+        m_queue.submit(RenderPass::Opaque, shader, mesh, &material, modelMatrix, viewDepth);
     }
 
+    // grouped by shader, then texture set, then arena page, front to back inside each group
+    m_queue.sort();
+    for (size_t i = 0; i < m_queue.size(); i++) {
+        const RenderItem& item = m_queue[i];
+        // dont unbind the shader, since we are LIKELY to use it again
+        const SceneUniforms& uniforms = UseSceneShader(*item.shader);
+        item.shader->SetUniform(uniforms.model, *item.model);
+        item.shader->SetUniform(uniforms.positionOffset, item.mesh->positionOffset);
+        item.shader->SetUniform(uniforms.positionScale, item.mesh->positionScale);
+        BindMaterialTextures(uniforms, *item.material);
+        DrawMesh(*item.mesh);
+    }
+    EndMeshDraws();
 }
 
-void Renderer::ShadowPass(entt::registry& registry, ShaderManager& shaderManager, ShadowMap& shadowMap, const glm::mat4& lightSpaceMatrix)
+void Renderer::OnShaderReloaded(const Shader& oldShader)
 {
-    glEnable(GL_DEPTH_TEST);
-    glDepthMask(GL_TRUE);
-    glCullFace(GL_FRONT); // Avoid shadow acne
+    // GL can hand the old program's name straight back out, so the cached sampler values have to go
+    m_state.invalidateProgram(oldShader.GetShaderID());
+    m_sceneUniforms = {};
+}
 
-    shadowMap.Bind();
-    glClear(GL_DEPTH_BUFFER_BIT);
+void Renderer::SetCamera(const glm::vec3& viewPosition, const glm::mat4& viewProjection, float pixelsPerUnit)
+{
+    m_viewPosition = viewPosition;
+    m_pixelsPerUnit = pixelsPerUnit;
+    m_culler.setFrustum(viewProjection);
+}
 
+void Renderer::ReportTextureUsage(const entt::registry& registry, entt::entity entity, const MaterialComponent& material) const
+{
+    // projected diameter of the bounding sphere, assumes the mesh spans its textures about once.
+    // Without bounds (or from inside them) ask for full resolution.
+    float screenPixels = std::numeric_limits<float>::max();
+    if (const auto* bounds = registry.try_get<BoundsComponent>(entity)) {
+        const float distance = glm::length(bounds->worldCenter - m_viewPosition) - bounds->worldRadius;
+        if (distance > 0.0f)
+            screenPixels = 2.0f * bounds->worldRadius * m_pixelsPerUnit / distance;
+    }
+
+    TextureManager& textureManager = TextureManager::getInstance();
+    textureManager.markTextureUsed(material.baseColorTextureID, screenPixels);
+    textureManager.markTextureUsed(material.normalTextureID, screenPixels);
+}
 
+const std::vector<entt::entity>& Renderer::CollectVisibleEntities(entt::registry& registry)
+{
+    if (m_useFrustumCulling)
+    {
+        // repacks every world AABB (Scene only recomputes the moved ones), then SIMD tests them
+        m_culler.update(registry);
+        m_culler.cull();
+        m_stats.entitiesTested = static_cast<unsigned int>(m_culler.getTestedCount());
+        m_stats.entitiesCulled = static_cast<unsigned int>(m_culler.getCulledCount());
+        return m_culler.getVisibleEntities();
+    }
 
-    // Iterate over entities with Mesh and Transform components
-    auto view = registry.view<MeshComponent, TransformComponent>();
+    m_stats.entitiesTested = 0;
+    m_stats.entitiesCulled = 0;
+    return CollectAllEntities(registry);
+}
+
+const std::vector<entt::entity>& Renderer::CollectShadowCasters(entt::registry& registry, const glm::mat4& lightSpaceMatrix,
+                                                                bool packBounds)
+{
+    if (m_useFrustumCulling)
+    {
+        m_shadowCuller.setFrustum(lightSpaceMatrix, false);
+        if (packBounds)
+            m_shadowCuller.update(registry);
+        m_shadowCuller.cull();
+        m_stats.shadowCastersCulled += static_cast<unsigned int>(m_shadowCuller.getCulledCount());
+        return m_shadowCuller.getVisibleEntities();
+    }
+
+    return CollectAllEntities(registry);
+}
+
+const std::vector<entt::entity>& Renderer::CollectAllEntities(entt::registry& registry)
+{
+    m_unculledEntities.clear();
+    auto view = registry.view<MeshComponent, WorldMatrixComponent, MaterialComponent>();
     for (auto entity : view) {
-        auto& mesh = registry.get<MeshComponent>(entity);
-        auto& transform = registry.get<TransformComponent>(entity);
-        auto& material = registry.get<MaterialComponent>(entity);
+        m_unculledEntities.push_back(entity);
+    }
+    return m_unculledEntities;
+}
 
-        auto shadowShader = shaderManager.getShader("shadowShader"); // for now we'll hard code this, remove it from main.
-        if (shadowShader->GetShaderID() != m_currentShaderID)
-        {
-            shadowShader->Bind();
-            m_currentShaderID = shadowShader->GetShaderID();
+void Renderer::ShadowPass(entt::registry& registry, ShaderManager& shaderManager, ShadowMap& shadowMap, uint64_t casterVersion)
+{
+    ProfileScope profileScope("Shadow pass");
 
-        }
-        shadowShader->SetUniformMat4f("lightSpaceMatrix", lightSpaceMatrix);
+    bool passStarted = false;
+    for (unsigned int cascade = 0; cascade < shadowMap.GetCascadeCount(); cascade++)
+    {
+        // nothing moved and the cascade's light volume didn't change, last frame's layer is still correct
+        if (shadowMap.IsCacheValid(cascade, casterVersion))
+            continue;
 
-        // check for decals and enable transparency CURRENTLY JUST NOT RENDERING DECAL MESHES
-        if (!material.isDecal)
+        if (!passStarted)
         {
-            glm::mat4 modelMatrix = transform.getModelMatrix();
-            shadowShader->SetUniformMat4f("model", modelMatrix);
+            glEnable(GL_DEPTH_TEST);
+            glDepthMask(GL_TRUE);
+            glCullFace(GL_FRONT); // Avoid shadow acne
+            // cascades are fitted tightly, clamping keeps casters in front of the near plane in the map
+            glEnable(GL_DEPTH_CLAMP);
+        }
 
-            glBindVertexArray(mesh.vao);
-            glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(mesh.indexCount), GL_UNSIGNED_INT, nullptr);
-            glBindVertexArray(0);
+        shadowMap.Bind(cascade);
+        glClear(GL_DEPTH_BUFFER_BIT);
+
+        const glm::mat4& lightSpaceMatrix = shadowMap.GetCascadeMatrix(cascade);
+        // the packed bounds are the same for every cascade, only the planes change
+        const std::vector<entt::entity>& casters = CollectShadowCasters(registry, lightSpaceMatrix, !passStarted);
+        passStarted = true;
+
+        if (!IsUsingIndirect() || !ShadowPassIndirect(registry, shaderManager, cascade, casters))
+        {
+            DrawShadowCasters(registry, shaderManager, cascade, casters);
         }
+
+        shadowMap.MarkCached(cascade, casterVersion);
+        m_stats.shadowCascadesRendered++;
     }
 
+    if (passStarted)
+    {
+        // shadowShader->Unbind();
+        shadowMap.Unbind();
+        glDisable(GL_DEPTH_CLAMP);
+        glCullFace(GL_BACK); // Reset to default cull face
+        glDepthMask(GL_TRUE);
+    }
+}
+
+void Renderer::DrawShadowCasters(entt::registry& registry, ShaderManager& shaderManager, unsigned int cascade,
+                                 const std::vector<entt::entity>& casters)
+{
+    m_state.invalidate();
+    m_queue.clear();
+
+    auto shadowShader = shaderManager.getShader("shadowShader"); // for now we'll hard code this, remove it from main.
 
-    // shadowShader->Unbind();
-    shadowMap.Unbind();
-    glCullFace(GL_BACK); // Reset to default cull face
-    glDepthMask(GL_TRUE);
+    // Iterate over the casters inside the light volume
+    for (auto entity : casters) {
+        // check for decals and enable transparency CURRENTLY JUST NOT RENDERING DECAL MESHES
+        if (registry.get<MaterialComponent>(entity).isDecal)
+            continue;
+
+        // depth only, so the arena page is the only state worth sorting on
+        m_queue.submit(RenderPass::Shadow, shadowShader.get(), registry.get<MeshComponent>(entity), nullptr,
+                       registry.get<WorldMatrixComponent>(entity).matrix, 0.0f);
+    }
+    m_queue.sort();
+
+    m_state.useProgram(shadowShader->GetShaderID());
+    // the light matrix itself comes from the shared ShadowBlock
+    shadowShader->SetUniform(shadowShader->GetUniformHandle<int>("cascadeIndex"), static_cast<int>(cascade));
+    const auto modelUniform = shadowShader->GetUniformHandle<glm::mat4>("model");
+    // only present when built for the compact vertex format, otherwise setting them is a no-op
+    const auto positionOffsetUniform = shadowShader->GetUniformHandle<glm::vec3>("positionOffset");
+    const auto positionScaleUniform = shadowShader->GetUniformHandle<glm::vec3>("positionScale");
+    for (size_t i = 0; i < m_queue.size(); i++) {
+        const RenderItem& item = m_queue[i];
+        shadowShader->SetUniform(modelUniform, *item.model);
+        shadowShader->SetUniform(positionOffsetUniform, item.mesh->positionOffset);
+        shadowShader->SetUniform(positionScaleUniform, item.mesh->positionScale);
+        DrawMesh(*item.mesh);
+    }
+    EndMeshDraws();
 }
 
 
@@ -150,36 +255,238 @@ void Renderer::LightingPass(entt::registry& registry, Shader& shader) const {
     glCullFace(GL_BACK);
     shader.Bind();
 
+    const auto modelUniform = shader.GetUniformHandle<glm::mat4>("model");
+    const auto positionOffsetUniform = shader.GetUniformHandle<glm::vec3>("positionOffset");
+    const auto positionScaleUniform = shader.GetUniformHandle<glm::vec3>("positionScale");
+    const auto diffuseUniform = shader.GetUniformHandle<int>("material.diffuse");
+    const auto normalUniform = shader.GetUniformHandle<int>("normalMap");
+
     // Iterate over entities with Mesh, Transform, and Material components
-    auto view = registry.view<MeshComponent, TransformComponent, MaterialComponent>();
+    auto view = registry.view<MeshComponent, WorldMatrixComponent, MaterialComponent>();
     for (auto entity : view) {
         auto& mesh = registry.get<MeshComponent>(entity);
-        auto& transform = registry.get<TransformComponent>(entity);
+        auto& worldMatrix = registry.get<WorldMatrixComponent>(entity);
         auto& material = registry.get<MaterialComponent>(entity);
 
-        glm::mat4 modelMatrix = transform.getModelMatrix();
-        shader.SetUniformMat4f("model", modelMatrix);
+        shader.SetUniform(modelUniform, worldMatrix.matrix);
+        shader.SetUniform(positionOffsetUniform, mesh.positionOffset);
+        shader.SetUniform(positionScaleUniform, mesh.positionScale);
 
         // Bind the diffuse texture
         if (material.baseColorTextureID != 0) {
             glActiveTexture(GL_TEXTURE0);
             glBindTexture(GL_TEXTURE_2D, material.baseColorTextureID);
-            shader.SetUniform1i("material.diffuse", 0);
+            shader.SetUniform(diffuseUniform, 0);
         } else {
             defaultTexture->bind(0);
-            shader.SetUniform1i("material.diffuse", 0);
+            shader.SetUniform(diffuseUniform, 0);
         }
         if (material.normalTextureID != 0)
         {
             glActiveTexture(GL_TEXTURE1);
             glBindTexture(GL_TEXTURE_2D, material.normalTextureID);
-            shader.SetUniform1i("normalMap", 1);
+            shader.SetUniform(normalUniform, 1);
         }
 
-        glBindVertexArray(mesh.vao);
-        glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(mesh.indexCount), GL_UNSIGNED_INT, nullptr);
-        glBindVertexArray(0);
+        DrawMesh(mesh);
     }
+    EndMeshDraws();
 
     shader.Unbind();
+}
+
+const Renderer::SceneUniforms& Renderer::UseSceneShader(const Shader& shader) const
+{
+    m_state.useProgram(shader.GetShaderID());
+    if (m_sceneUniforms.shader != &shader) {
+        m_sceneUniforms.shader = &shader;
+        m_sceneUniforms.model = shader.GetUniformHandle<glm::mat4>("model");
+        m_sceneUniforms.positionOffset = shader.GetUniformHandle<glm::vec3>("positionOffset");
+        m_sceneUniforms.positionScale = shader.GetUniformHandle<glm::vec3>("positionScale");
+        m_sceneUniforms.albedoMap = shader.GetUniformHandle<int>("albedoMap");
+        m_sceneUniforms.normalMap = shader.GetUniformHandle<int>("normalMap");
+    }
+    return m_sceneUniforms;
+}
+
+void Renderer::BindMaterialTextures(const SceneUniforms& uniforms, const MaterialComponent& material) const
+{
+    const Shader& shader = *uniforms.shader;
+    // Bind the diffuse texture
+    if (material.baseColorTextureID != 0) {
+        m_state.bindTexture(0, material.baseColorTextureID);
+    } else {
+        m_state.bindTexture(0, defaultTexture->getID());
+    }
+    m_state.setSamplerUniform(shader, uniforms.albedoMap, 0);
+    // variants built without the feature don't have the sampler, so there is nothing to bind
+    if (material.normalTextureID != 0 && uniforms.normalMap.isValid())
+    {
+        m_state.bindTexture(1, material.normalTextureID);
+        m_state.setSamplerUniform(shader, uniforms.normalMap, 1);
+    }
+}
+
+ShaderVariantKey Renderer::GetMaterialVariant(const MaterialComponent& material) const
+{
+    ShaderVariantKey features = 0;
+    if (material.normalTextureID != 0)
+        features |= ShaderFeature::NormalMap;
+    if (material.alphaTested)
+        features |= ShaderFeature::AlphaTest;
+    return makeShaderVariant(features, m_shadowPcfLevel);
+}
+
+/*
+ * Batched version of Render. Draws are sorted by shader, arena page and texture set, every mesh gets a
+ * DrawElementsIndirectCommand plus its model matrix in the per-draw SSBO, and each run of draws sharing
+ * that state is submitted with a single glMultiDrawElementsIndirect. Textures are still bound per run.
+ * Returns false (without drawing anything) if the frame can't go down this path.
+ */
+bool Renderer::RenderIndirect(entt::registry& registry, ShaderManager& shaderManager, const std::vector<entt::entity>& entities)
+{
+    m_queuedIndirectDraws.clear();
+
+    for (auto entity : entities) {
+        auto& material = registry.get<MaterialComponent>(entity);
+        // CURRENTLY JUST NOT RENDERING DECAL MESHES
+        if (material.isDecal)
+            continue;
+
+        const std::string indirectShaderID = material.shaderID + "Indirect";
+        if (!shaderManager.hasShader(indirectShaderID))
+            return false;
+
+        ReportTextureUsage(registry, entity, material);
+        m_queuedIndirectDraws.push_back({shaderManager.getVariant(indirectShaderID, GetMaterialVariant(material)).get(),
+                                         &registry.get<MeshComponent>(entity), &material,
+                                         &registry.get<WorldMatrixComponent>(entity).matrix});
+    }
+    if (m_queuedIndirectDraws.size() > GeometryArena::kMaxDrawIDs)
+        return false;
+
+    auto sortKey = [](const QueuedIndirectDraw& draw) {
+        return std::make_tuple(draw.shader->GetShaderID(), draw.mesh->vao, draw.material->baseColorTextureID,
+                               draw.material->normalTextureID);
+    };
+    std::sort(m_queuedIndirectDraws.begin(), m_queuedIndirectDraws.end(),
+              [&sortKey](const QueuedIndirectDraw& a, const QueuedIndirectDraw& b) { return sortKey(a) < sortKey(b); });
+
+    m_indirectBuffer->clear();
+    auto& commands = m_indirectBuffer->commands();
+    auto& drawData = m_indirectBuffer->drawData();
+    for (const auto& draw : m_queuedIndirectDraws) {
+        GLuint drawID = static_cast<GLuint>(commands.size());
+        commands.push_back({static_cast<GLuint>(draw.mesh->indexCount), 1, draw.mesh->firstIndex, draw.mesh->baseVertex, drawID});
+        m_stats.triangles += static_cast<unsigned int>(draw.mesh->indexCount / 3);
+        drawData.push_back({*draw.model, glm::vec4(draw.mesh->positionOffset, 0.0f), glm::vec4(draw.mesh->positionScale, 0.0f)});
+    }
+    m_indirectBuffer->upload();
+
+    m_state.invalidate();
+    m_sceneUniforms = {};
+    size_t bucketStart = 0;
+    while (bucketStart < m_queuedIndirectDraws.size()) {
+        const QueuedIndirectDraw& first = m_queuedIndirectDraws[bucketStart];
+        size_t bucketEnd = bucketStart + 1;
+        while (bucketEnd < m_queuedIndirectDraws.size() && sortKey(m_queuedIndirectDraws[bucketEnd]) == sortKey(first))
+            bucketEnd++;
+
+        BindMaterialTextures(UseSceneShader(*first.shader), *first.material);
+        m_state.bindVertexArray(first.mesh->vao);
+
+        m_indirectBuffer->draw(bucketStart, bucketEnd - bucketStart);
+        m_stats.drawCalls++;
+        m_stats.meshesSubmitted += static_cast<unsigned int>(bucketEnd - bucketStart);
+        bucketStart = bucketEnd;
+    }
+    EndMeshDraws();
+    return true;
+}
+
+// Depth only, so the only thing that splits a batch is the arena page
+bool Renderer::ShadowPassIndirect(entt::registry& registry, ShaderManager& shaderManager, unsigned int cascade,
+                                  const std::vector<entt::entity>& entities)
+{
+    if (!shaderManager.hasShader("shadowShaderIndirect"))
+        return false;
+    auto shadowShader = shaderManager.getShader("shadowShaderIndirect");
+
+    m_queuedIndirectDraws.clear();
+    for (auto entity : entities) {
+        auto& material = registry.get<MaterialComponent>(entity);
+        if (material.isDecal)
+            continue;
+        m_queuedIndirectDraws.push_back({shadowShader.get(), &registry.get<MeshComponent>(entity), &material,
+                                         &registry.get<WorldMatrixComponent>(entity).matrix});
+    }
+    if (m_queuedIndirectDraws.size() > GeometryArena::kMaxDrawIDs)
+        return false;
+
+    std::sort(m_queuedIndirectDraws.begin(), m_queuedIndirectDraws.end(),
+              [](const QueuedIndirectDraw& a, const QueuedIndirectDraw& b) { return a.mesh->vao < b.mesh->vao; });
+
+    m_indirectBuffer->clear();
+    auto& commands = m_indirectBuffer->commands();
+    auto& drawData = m_indirectBuffer->drawData();
+    for (const auto& draw : m_queuedIndirectDraws) {
+        GLuint drawID = static_cast<GLuint>(commands.size());
+        commands.push_back({static_cast<GLuint>(draw.mesh->indexCount), 1, draw.mesh->firstIndex, draw.mesh->baseVertex, drawID});
+        m_stats.triangles += static_cast<unsigned int>(draw.mesh->indexCount / 3);
+        drawData.push_back({*draw.model, glm::vec4(draw.mesh->positionOffset, 0.0f), glm::vec4(draw.mesh->positionScale, 0.0f)});
+    }
+    m_indirectBuffer->upload();
+
+    m_state.invalidate();
+    m_state.useProgram(shadowShader->GetShaderID());
+    // the light matrix itself comes from the shared ShadowBlock
+    shadowShader->SetUniform(shadowShader->GetUniformHandle<int>("cascadeIndex"), static_cast<int>(cascade));
+
+    size_t bucketStart = 0;
+    while (bucketStart < m_queuedIndirectDraws.size()) {
+        GLuint vao = m_queuedIndirectDraws[bucketStart].mesh->vao;
+        size_t bucketEnd = bucketStart + 1;
+        while (bucketEnd < m_queuedIndirectDraws.size() && m_queuedIndirectDraws[bucketEnd].mesh->vao == vao)
+            bucketEnd++;
+
+        m_state.bindVertexArray(vao);
+        m_indirectBuffer->draw(bucketStart, bucketEnd - bucketStart);
+        m_stats.drawCalls++;
+        m_stats.meshesSubmitted += static_cast<unsigned int>(bucketEnd - bucketStart);
+        bucketStart = bucketEnd;
+    }
+    EndMeshDraws();
+    return true;
+}
+
+void Renderer::DrawMesh(const MeshComponent& mesh) const
+{
+    // meshes share arena VAOs, so this only rebinds when we cross into another page
+    m_state.bindVertexArray(mesh.vao);
+    glDrawElementsBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(mesh.indexCount), GL_UNSIGNED_INT,
+                             reinterpret_cast<const void*>(static_cast<size_t>(mesh.firstIndex) * sizeof(unsigned int)),
+                             mesh.baseVertex);
+    m_stats.drawCalls++;
+    m_stats.meshesSubmitted++;
+    m_stats.triangles += static_cast<unsigned int>(mesh.indexCount / 3);
+}
+
+void Renderer::EndMeshDraws() const
+{
+    // other code (ImGui, the framebuffer quad) binds VAOs behind our back, so forget the cache between passes
+    glBindVertexArray(0);
+    m_state.invalidate();
+}
+
+void Renderer::ResetStats()
+{
+    m_stats = RenderStats();
+    m_state.resetCounters();
+}
+
+const RenderStats& Renderer::GetStats() const
+{
+    m_stats.stateChanges = m_state.getIssuedCount();
+    m_stats.stateChangesSkipped = m_state.getSkippedCount();
+    return m_stats;
 }
\ No newline at end of file
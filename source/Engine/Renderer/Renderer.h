@@ -2,14 +2,34 @@
 #define RENDERER_H
 
 
+#include <algorithm>
 #include <entt/entt.hpp>
 
 #include "../Actors/ModelData.h" // Include the new ModelData structures
 #include "Shader.h"             // Forward declare the Shader class
 #include "ShaderManager.h"
+#include "ShaderVariant.h"
 #include "ShadowMap.h"
+#include "IndirectDrawBuffer.h"
+#include "RenderQueue.h"
+#include "FrustumCuller.h"
 #include "Importers/AssimpImporter.h"
 
+struct MaterialComponent;
+
+// Per-frame counters, reset with Renderer::ResetStats()
+struct RenderStats
+{
+    unsigned int drawCalls = 0;         // glDraw* / glMultiDraw* calls issued
+    unsigned int meshesSubmitted = 0;   // meshes those calls covered
+    unsigned int triangles = 0;         // triangles those meshes contain
+    unsigned int stateChanges = 0;      // program/texture/VAO/sampler changes sent to GL
+    unsigned int stateChangesSkipped = 0; // ones the state tracker dropped as redundant
+    unsigned int entitiesTested = 0;    // entities frustum tested by the main pass
+    unsigned int entitiesCulled = 0;    // ones that were outside the camera frustum
+    unsigned int shadowCastersCulled = 0; // casters outside the light volume, summed over cascades
+    unsigned int shadowCascadesRendered = 0; // cascades redrawn, the rest reused last frame's layer
+};
 
 class Renderer
 {
@@ -24,20 +44,104 @@ public:
     // Render multiple ModelData objects
     // void Render(const std::vector<ModelData>& models, Shader& shader) const;
 
-    // Draws the scene to the shadow map
-    void ShadowPass(entt::registry& registry, ShaderManager& shaderManager, ShadowMap& shadowMap,
-                    const glm::mat4& lightSpaceMatrix);
+    // Draws each cascade's casters into its layer of the shadow map (call ShadowMap::UpdateCascades first).
+    // Cascades whose cached layer is still valid for their light matrix and casterVersion
+    // (Scene::getShadowCasterVersion()) are skipped.
+    void ShadowPass(entt::registry& registry, ShaderManager& shaderManager, ShadowMap& shadowMap, uint64_t casterVersion);
     // render the final scene including the shadow map
     void LightingPass(entt::registry& registry, Shader& shader) const;
 
+    // Multi-draw-indirect path, needs a 4.3 context plus "<shaderID>Indirect" shaders loaded in the ShaderManager.
+    // When unavailable Render/ShadowPass fall back to one draw per mesh.
+    bool IsIndirectSupported() const { return m_indirectSupported; }
+    void SetUseIndirect(bool useIndirect) { m_useIndirect = useIndirect; }
+    bool IsUsingIndirect() const { return m_indirectSupported && m_useIndirect; }
+
+    // camera position is used for the front-to-back part of the sort key, viewProjection for frustum culling.
+    // pixelsPerUnit is the size in pixels of one world unit at distance one (viewport height / 2 * projection[1][1]),
+    // used to tell the TextureManager how big each material is drawn.
+    void SetCamera(const glm::vec3& viewPosition, const glm::mat4& viewProjection, float pixelsPerUnit);
+
+    // Main pass only draws entities whose BoundsComponent is inside the camera frustum
+    void SetUseFrustumCulling(bool useCulling) { m_useFrustumCulling = useCulling; }
+    bool IsUsingFrustumCulling() const { return m_useFrustumCulling; }
+
+    // Shadow filter compiled into the scene shader variants, 0 to ShaderFeature::kMaxPcfLevel
+    void SetShadowPcfLevel(unsigned int level) { m_shadowPcfLevel = std::min(level, ShaderFeature::kMaxPcfLevel); }
+    unsigned int GetShadowPcfLevel() const { return m_shadowPcfLevel; }
+    // The variant of a scene shader a material is drawn with: only the features it actually uses
+    ShaderVariantKey GetMaterialVariant(const MaterialComponent& material) const;
+
+    void ResetStats();
+    const RenderStats& GetStats() const;
+
+    // Forgets everything cached against a program that ShaderManager has just replaced
+    void OnShaderReloaded(const Shader& oldShader);
+
 private:
     // why is this still here? it needs to go
     Texture* defaultTexture;
 
-    // used to cache the current shader ID
-    unsigned int m_currentShaderID = 0;
+    // drops redundant program/texture/VAO/sampler calls, replaces the old shader ID and VAO caches
+    mutable RenderStateTracker m_state;
+    RenderQueue m_queue;
+    glm::vec3 m_viewPosition = glm::vec3(0.0f);
+    float m_pixelsPerUnit = 0.0f;
+
+    FrustumCuller m_culler;
+    FrustumCuller m_shadowCuller;
+    bool m_useFrustumCulling = true;
+    unsigned int m_shadowPcfLevel = 1;
+    std::vector<entt::entity> m_unculledEntities;
+
+    // entities with bounds that the main pass should draw this frame
+    const std::vector<entt::entity>& CollectVisibleEntities(entt::registry& registry);
+    // entities with bounds that can throw a shadow into the light volume
+    const std::vector<entt::entity>& CollectShadowCasters(entt::registry& registry, const glm::mat4& lightSpaceMatrix,
+                                                          bool packBounds);
+    const std::vector<entt::entity>& CollectAllEntities(entt::registry& registry);
 
     void RenderEntity(entt::registry& registry, entt::entity entity, Shader& shader);
+    // Residency feedback: how many pixels across the entity's textures are drawn at
+    void ReportTextureUsage(const entt::registry& registry, entt::entity entity, const MaterialComponent& material) const;
+    void DrawMesh(const MeshComponent& mesh) const;
+    void EndMeshDraws() const;
+
+    // Handles the scene passes set per draw, resolved whenever the pass switches program
+    struct SceneUniforms
+    {
+        const Shader* shader = nullptr;
+        UniformHandle<glm::mat4> model;
+        UniformHandle<glm::vec3> positionOffset; // compact vertex format only, invalid otherwise
+        UniformHandle<glm::vec3> positionScale;
+        UniformHandle<int> albedoMap;
+        UniformHandle<int> normalMap;
+    };
+
+    const SceneUniforms& UseSceneShader(const Shader& shader) const;
+    void BindMaterialTextures(const SceneUniforms& uniforms, const MaterialComponent& material) const;
+
+    struct QueuedIndirectDraw
+    {
+        Shader* shader;
+        const MeshComponent* mesh;
+        const MaterialComponent* material;
+        const glm::mat4* model;
+    };
+
+    bool RenderIndirect(entt::registry& registry, ShaderManager& shaderManager, const std::vector<entt::entity>& entities);
+    void DrawShadowCasters(entt::registry& registry, ShaderManager& shaderManager, unsigned int cascade,
+                           const std::vector<entt::entity>& casters);
+    bool ShadowPassIndirect(entt::registry& registry, ShaderManager& shaderManager, unsigned int cascade,
+                            const std::vector<entt::entity>& entities);
+
+    bool m_indirectSupported = false;
+    bool m_useIndirect = true;
+    std::unique_ptr<IndirectDrawBuffer> m_indirectBuffer;
+    std::vector<QueuedIndirectDraw> m_queuedIndirectDraws;
+
+    mutable RenderStats m_stats;
+    mutable SceneUniforms m_sceneUniforms;
 };
 
 #endif //RENDERER_H
@@ -7,40 +7,51 @@
  */
 
 #include "ShadowMap.h"
-#include <iostream>
+#include <algorithm>
+#include <cmath>
 #include <glm/gtc/matrix_transform.hpp>
-ShadowMap::ShadowMap(unsigned int width, unsigned int height)
-    : shadowMapFBO(0), shadowMapTexture(0), width(width), height(height) {
+
+#include "Camera.h"
+#include "Logger.h"
+
+ShadowMap::ShadowMap(unsigned int resolution, unsigned int cascadeCount)
+    : shadowMapFBO(0), shadowMapTexture(0), resolution(resolution),
+      cascadeCount(std::min(std::max(cascadeCount, 1u), kMaxCascades)) {
+    for (unsigned int i = 0; i < kMaxCascades; i++) {
+        m_cascadeMatrices[i] = glm::mat4(1.0f);
+        m_cachedMatrices[i] = glm::mat4(1.0f);
+    }
+
     // Generate the framebuffer
     glGenFramebuffers(1, &shadowMapFBO);
 
-    // Generate the depth texture
+    // Generate the depth texture, one layer per cascade
     glGenTextures(1, &shadowMapTexture);
-    glBindTexture(GL_TEXTURE_2D, shadowMapTexture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT32F, width, height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, shadowMapTexture);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT32F, resolution, resolution, this->cascadeCount, 0,
+                 GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_LESS);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_FUNC, GL_LESS);
 
-
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
 
     // **Uncomment and set the border color to white**
     float borderColor[] = {1.0f, 1.0f, 1.0f, 1.0f};
-    glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
+    glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, borderColor);
 
-    // Attach the depth texture to the framebuffer
+    // Attach the first layer to check the framebuffer, Bind() swaps in the others
     glBindFramebuffer(GL_FRAMEBUFFER, shadowMapFBO);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, shadowMapTexture, 0);
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, shadowMapTexture, 0, 0);
     glDrawBuffer(GL_NONE); // No color buffer is drawn
     glReadBuffer(GL_NONE);
 
     // Check framebuffer status
     if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
-        std::cerr << "ShadowMap framebuffer is not complete!" << std::endl;
+        LOG_ERROR(Renderer, "ShadowMap framebuffer is not complete!");
     }
 
     glBindFramebuffer(GL_FRAMEBUFFER, 0); // Unbind the framebuffer
@@ -51,9 +62,10 @@ ShadowMap::~ShadowMap() {
     glDeleteTextures(1, &shadowMapTexture);
 }
 
-void ShadowMap::Bind() {
+void ShadowMap::Bind(unsigned int cascade) {
     glBindFramebuffer(GL_FRAMEBUFFER, shadowMapFBO);
-    glViewport(0, 0, width, height); // Set viewport size to shadow map resolution
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, shadowMapTexture, 0, static_cast<GLint>(cascade));
+    glViewport(0, 0, resolution, resolution); // Set viewport size to shadow map resolution
 }
 
 void ShadowMap::Unbind() {
@@ -64,22 +76,80 @@ GLuint ShadowMap::GetDepthTexture() const {
     return shadowMapTexture;
 }
 
-glm::mat4 ShadowMap::CalculateLightSpaceMatrix(const glm::vec3& lightDirection) {
-    // Normalize the light direction
-    glm::vec3 normalizedLightDir = glm::normalize(lightDirection);
+void ShadowMap::UpdateCascades(const Camera& camera, const glm::vec3& lightDirection) {
+    const float nearPlane = camera.getNearPlane();
+    const float farPlane = camera.getFarPlane();
 
-    // Define a fixed orthographic projection for the shadow map
-    float orthoSize = 15.0f; // Adjust based on your scene's size
-    glm::mat4 lightProjection = glm::ortho(-orthoSize, orthoSize, -orthoSize, orthoSize, 1.0f, 50.0f);
-    // glm::mat4 lightProjection = glm::perspective(glm::radians(90.0f), 1.0f, 0.1f, 100.0f);
+    // "practical" split scheme, a blend of logarithmic and uniform splits
+    for (unsigned int i = 0; i < cascadeCount; i++) {
+        float fraction = static_cast<float>(i + 1) / static_cast<float>(cascadeCount);
+        float logSplit = nearPlane * std::pow(farPlane / nearPlane, fraction);
+        float uniformSplit = nearPlane + (farPlane - nearPlane) * fraction;
+        m_cascadeSplits[i] = m_splitLambda * logSplit + (1.0f - m_splitLambda) * uniformSplit;
+    }
 
+    // light rotation only, cascades are positioned by offsetting the ortho bounds in this space
+    glm::vec3 normalizedLightDir = glm::normalize(lightDirection);
+    glm::vec3 up = std::abs(normalizedLightDir.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+    glm::mat4 lightView = glm::lookAt(glm::vec3(0.0f), normalizedLightDir, up);
+
+    const glm::mat4 cameraView = camera.getViewMatrix();
+    float sliceNear = nearPlane;
+    for (unsigned int i = 0; i < cascadeCount; i++) {
+        float sliceFar = m_cascadeSplits[i];
+
+        // world space corners of this slice of the camera frustum
+        glm::mat4 sliceProjection = glm::perspective(glm::radians(camera.getFOV()), camera.getAspectRatio(), sliceNear, sliceFar);
+        glm::mat4 inverseSlice = glm::inverse(sliceProjection * cameraView);
+        glm::vec3 corners[8];
+        glm::vec3 center(0.0f);
+        for (int c = 0; c < 8; c++) {
+            glm::vec4 corner = inverseSlice * glm::vec4((c & 1) ? 1.0f : -1.0f, (c & 2) ? 1.0f : -1.0f, (c & 4) ? 1.0f : -1.0f, 1.0f);
+            corners[c] = glm::vec3(corner) / corner.w;
+            center += corners[c];
+        }
+        center /= 8.0f;
+
+        // bounding sphere radius only depends on the slice shape, so the volume size is stable while the camera moves
+        float radius = 0.0f;
+        for (const auto& corner : corners) {
+            radius = std::max(radius, glm::length(corner - center));
+        }
+        radius = std::ceil(radius * 16.0f) / 16.0f;
+
+        // snap the centre to whole texels across the light direction, and to coarse steps along it
+        // so the matrix (and so the cached layer) stays identical across small camera moves
+        const float texelSize = (2.0f * radius) / static_cast<float>(resolution);
+        const float depthStep = radius * 0.25f;
+        glm::vec3 lightSpaceCenter = glm::vec3(lightView * glm::vec4(center, 1.0f));
+        lightSpaceCenter.x = std::floor(lightSpaceCenter.x / texelSize) * texelSize;
+        lightSpaceCenter.y = std::floor(lightSpaceCenter.y / texelSize) * texelSize;
+        lightSpaceCenter.z = std::floor(lightSpaceCenter.z / depthStep) * depthStep;
+
+        // the pass renders with depth clamping, so casters in front of the near plane still land in the map
+        float centerDistance = -lightSpaceCenter.z;
+        glm::mat4 lightProjection = glm::ortho(lightSpaceCenter.x - radius, lightSpaceCenter.x + radius,
+                                               lightSpaceCenter.y - radius, lightSpaceCenter.y + radius,
+                                               centerDistance - radius - depthStep, centerDistance + radius + depthStep);
+
+        m_cascadeMatrices[i] = lightProjection * lightView;
+        sliceNear = sliceFar;
+    }
+}
 
-    // Calculate the light's view matrix
-    // Position the light sufficiently far to cover the scene
-    glm::mat4 lightView = glm::lookAt(-normalizedLightDir * 30.0f, // Increased distance for broader coverage
-                                      glm::vec3(0.0f),
-                                      glm::vec3(0.0f, 1.0f, 0.0f));
+bool ShadowMap::IsCacheValid(unsigned int cascade, uint64_t casterVersion) const {
+    return m_cacheValid[cascade] && casterVersion == m_cachedCasterVersions[cascade] &&
+           m_cascadeMatrices[cascade] == m_cachedMatrices[cascade];
+}
 
-    // Combine projection and view matrices
-    return lightProjection * lightView;
-}
\ No newline at end of file
+void ShadowMap::MarkCached(unsigned int cascade, uint64_t casterVersion) {
+    m_cacheValid[cascade] = true;
+    m_cachedMatrices[cascade] = m_cascadeMatrices[cascade];
+    m_cachedCasterVersions[cascade] = casterVersion;
+}
+
+void ShadowMap::InvalidateCache() {
+    for (bool& valid : m_cacheValid) {
+        valid = false;
+    }
+}
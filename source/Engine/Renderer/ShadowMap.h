@@ -4,24 +4,63 @@
 
 #ifndef SHADOWMAP_H
 #define SHADOWMAP_H
+#include <cstdint>
 #include <GL/glew.h>
-#include <glm/fwd.hpp>
+#include <glm/glm.hpp>
 
+class Camera;
+
+/**
+ * @brief Cascaded directional shadow map.
+ *
+ * The camera frustum is split into up to kMaxCascades slices between its near and far planes and each
+ * slice gets its own ortho light volume, rendered into one layer of a depth texture array. Volumes are
+ * fitted to the slice's bounding sphere (so their size doesn't change as the camera turns) and snapped
+ * to whole texels in light space (so shadows don't shimmer as it moves).
+ */
 class ShadowMap {
 public:
-    ShadowMap(unsigned int width, unsigned int height);
+    static constexpr unsigned int kMaxCascades = 4;
+
+    // resolution is per cascade, 4 x 1024^2 costs the same memory as a single 2048^2 map
+    ShadowMap(unsigned int resolution, unsigned int cascadeCount);
     ~ShadowMap();
 
-    void Bind();
+    // Binds the FBO with the given cascade's layer attached
+    void Bind(unsigned int cascade);
     void Unbind();
     GLuint GetDepthTexture() const;
+    unsigned int GetResolution() const { return resolution; }
+    unsigned int GetCascadeCount() const { return cascadeCount; }
+
+    // Recomputes the split distances and light matrices for this frame
+    void UpdateCascades(const Camera& camera, const glm::vec3& lightDirection);
+    const glm::mat4& GetCascadeMatrix(unsigned int cascade) const { return m_cascadeMatrices[cascade]; }
+    // view space distance where the cascade ends
+    float GetCascadeSplit(unsigned int cascade) const { return m_cascadeSplits[cascade]; }
 
-    glm::mat4 CalculateLightSpaceMatrix(const glm::vec3& lightDirection);
+    // 0 = even splits, 1 = logarithmic splits
+    void SetSplitLambda(float lambda) { m_splitLambda = lambda; }
+
+    // Each layer is kept between frames. It only needs redrawing when its light matrix or the set of
+    // casters (tracked by Scene::getShadowCasterVersion()) changed since it was last rendered.
+    bool IsCacheValid(unsigned int cascade, uint64_t casterVersion) const;
+    void MarkCached(unsigned int cascade, uint64_t casterVersion);
+    void InvalidateCache();
 
 private:
     GLuint shadowMapFBO;
     GLuint shadowMapTexture;
-    unsigned int width, height;
+    unsigned int resolution;
+    unsigned int cascadeCount;
+
+    float m_splitLambda = 0.75f;
+    glm::mat4 m_cascadeMatrices[kMaxCascades];
+    float m_cascadeSplits[kMaxCascades] = {};
+
+    bool m_cacheValid[kMaxCascades] = {};
+    glm::mat4 m_cachedMatrices[kMaxCascades];
+    uint64_t m_cachedCasterVersions[kMaxCascades] = {};
 };
 
 #endif //SHADOWMAP_H
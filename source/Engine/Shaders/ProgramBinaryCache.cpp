@@ -0,0 +1,215 @@
+//
+// Created by Shaun on 17/10/2026.
+//
+
+#include "ProgramBinaryCache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+#include <GL/glew.h>
+
+#include "AtomicFile.h"
+#include "Logger.h"
+#include "MappedFile.h"
+
+/*
+ * File name: "<slot>-<key>.glprog", both 16 hex digits. Layout (little endian, no padding between fields):
+ *
+ * | magic "EPRG" | version | key (uint64) | driver string length | driver string bytes |
+ * | binary format | binary length | binary bytes |
+ */
+namespace
+{
+    constexpr char kMagic[4] = {'E', 'P', 'R', 'G'};
+
+    // 64-bit FNV-1a, continued across calls by passing the previous hash back in
+    uint64_t hashBytes(const void* data, size_t size, uint64_t hash = 14695981039346656037ull)
+    {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; i++) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    const char* glString(GLenum name)
+    {
+        const GLubyte* value = glGetString(name);
+        return value ? reinterpret_cast<const char*>(value) : "";
+    }
+}
+
+bool ProgramBinaryCache::isSupported()
+{
+    static const bool supported = [] {
+        if (!GLEW_VERSION_4_1 && !GLEW_ARB_get_program_binary)
+            return false;
+        GLint formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        return formats > 0;
+    }();
+    return supported;
+}
+
+void ProgramBinaryCache::markRetrievable(unsigned int program)
+{
+    if (isSupported())
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+}
+
+const std::string& ProgramBinaryCache::getDriverString()
+{
+    static const std::string driver = std::string(glString(GL_VENDOR)) + "|" + glString(GL_RENDERER) + "|" +
+                                      glString(GL_VERSION);
+    return driver;
+}
+
+uint64_t ProgramBinaryCache::getKey(const std::string& vertexSource, const std::string& fragmentSource)
+{
+    // the separators stop "ab" + "c" and "a" + "bc" hashing the same
+    const char separator = '\0';
+    uint64_t hash = hashBytes(getDriverString().data(), getDriverString().size());
+    hash = hashBytes(&separator, 1, hash);
+    hash = hashBytes(vertexSource.data(), vertexSource.size(), hash);
+    hash = hashBytes(&separator, 1, hash);
+    return hashBytes(fragmentSource.data(), fragmentSource.size(), hash);
+}
+
+uint64_t ProgramBinaryCache::getSlot(const std::string& programName)
+{
+    return hashBytes(programName.data(), programName.size());
+}
+
+std::string ProgramBinaryCache::getFileName(uint64_t slot, uint64_t key)
+{
+    char name[48];
+    std::snprintf(name, sizeof(name), "%016llx-%016llx.glprog", static_cast<unsigned long long>(slot),
+                  static_cast<unsigned long long>(key));
+    return name;
+}
+
+void ProgramBinaryCache::pruneSlot(const std::string& keepFileName)
+{
+    // "<slot>-", every entry that starts with it belongs to the same program
+    const std::string slotPrefix = keepFileName.substr(0, 17);
+
+    std::vector<std::filesystem::path> stale;
+    std::error_code error;
+    for (std::filesystem::directory_iterator it(kCacheDirectory, error), end; !error && it != end; it.increment(error)) {
+        const std::string name = it->path().filename().string();
+        if (it->path().extension() != ".glprog" || name == keepFileName)
+            continue;
+        // older binaries of this program, or files from the version 1 layout that had no slot
+        const bool superseded = name.compare(0, slotPrefix.size(), slotPrefix) == 0;
+        const bool unslotted = name.size() != keepFileName.size() || name[16] != '-';
+        if (superseded || unslotted)
+            stale.push_back(it->path());
+    }
+
+    for (const auto& path : stale) {
+        std::filesystem::remove(path, error);
+        LOG_DEBUG(Shader, "Pruned stale program binary " << path.filename().string());
+    }
+}
+
+bool ProgramBinaryCache::load(unsigned int program, const std::string& programName, const std::string& vertexSource,
+                              const std::string& fragmentSource)
+{
+    if (!isSupported())
+        return false;
+
+    const uint64_t key = getKey(vertexSource, fragmentSource);
+    const std::string cachePath = std::string(kCacheDirectory) + "/" + getFileName(getSlot(programName), key);
+    MappedFile file(cachePath);
+    if (!file.isOpen())
+        return false;
+
+    const unsigned char* data = file.data();
+    const size_t size = file.size();
+    size_t offset = 0;
+    auto read = [&](void* out, size_t bytes) {
+        if (bytes > size - offset)
+            return false;
+        std::memcpy(out, data + offset, bytes);
+        offset += bytes;
+        return true;
+    };
+
+    char magic[4];
+    uint32_t version = 0, driverLength = 0, format = 0, length = 0;
+    uint64_t storedKey = 0;
+    if (!read(magic, sizeof(magic)) || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0)
+        return false;
+    if (!read(&version, sizeof(version)) || version != kVersion)
+        return false;
+    if (!read(&storedKey, sizeof(storedKey)) || storedKey != key)
+        return false;
+    if (!read(&driverLength, sizeof(driverLength)) || driverLength > size - offset)
+        return false;
+    const std::string& driver = getDriverString();
+    if (driverLength != driver.size() || std::memcmp(data + offset, driver.data(), driverLength) != 0)
+        return false;
+    offset += driverLength;
+    if (!read(&format, sizeof(format)) || !read(&length, sizeof(length)) || length > size - offset)
+        return false;
+
+    glProgramBinary(program, format, data + offset, static_cast<GLsizei>(length));
+    GLint linked = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (linked != GL_TRUE) {
+        LOG_DEBUG(Shader, "Program binary " << cachePath << " rejected by the driver, recompiling");
+        return false;
+    }
+    return true;
+}
+
+bool ProgramBinaryCache::save(unsigned int program, const std::string& programName, const std::string& vertexSource,
+                              const std::string& fragmentSource)
+{
+    if (!isSupported())
+        return false;
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return false;
+
+    std::vector<unsigned char> binary(static_cast<size_t>(length));
+    GLenum format = 0;
+    GLsizei written = 0;
+    glGetProgramBinary(program, length, &written, &format, binary.data());
+    if (written <= 0)
+        return false;
+
+    std::error_code error;
+    std::filesystem::create_directories(kCacheDirectory, error);
+    if (error) {
+        LOG_ERROR(Shader, "ProgramBinaryCache: failed to create " << kCacheDirectory << ": " << error.message());
+        return false;
+    }
+
+    const uint64_t key = getKey(vertexSource, fragmentSource);
+    const std::string fileName = getFileName(getSlot(programName), key);
+    const std::string cachePath = std::string(kCacheDirectory) + "/" + fileName;
+    const bool saved = writeFileAtomically(cachePath, LogCategory::Shader, [&](std::ostream& stream) {
+        const std::string& driver = getDriverString();
+        const auto version = static_cast<uint32_t>(kVersion);
+        const auto driverLength = static_cast<uint32_t>(driver.size());
+        const auto binaryFormat = static_cast<uint32_t>(format);
+        const auto binaryLength = static_cast<uint32_t>(written);
+        stream.write(kMagic, sizeof(kMagic));
+        stream.write(reinterpret_cast<const char*>(&version), sizeof(version));
+        stream.write(reinterpret_cast<const char*>(&key), sizeof(key));
+        stream.write(reinterpret_cast<const char*>(&driverLength), sizeof(driverLength));
+        stream.write(driver.data(), driverLength);
+        stream.write(reinterpret_cast<const char*>(&binaryFormat), sizeof(binaryFormat));
+        stream.write(reinterpret_cast<const char*>(&binaryLength), sizeof(binaryLength));
+        stream.write(reinterpret_cast<const char*>(binary.data()), binaryLength);
+    });
+    if (saved)
+        pruneSlot(fileName);
+    return saved;
+}
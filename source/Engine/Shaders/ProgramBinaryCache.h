@@ -0,0 +1,51 @@
+//
+// Created by Shaun on 17/10/2026.
+//
+
+#ifndef PROGRAMBINARYCACHE_H
+#define PROGRAMBINARYCACHE_H
+
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief On-disk cache of linked GL program binaries (glGetProgramBinary / glProgramBinary).
+ *
+ * Entries live in kCacheDirectory, one file per program, named "<slot>-<key>.glprog". The slot hashes
+ * the program's identity (file names and defines), the key hashes both stage sources and the driver's
+ * vendor/renderer/version strings. The full driver string is stored in the file as well, so a driver
+ * update (or a different GPU) is a miss. Drivers may also reject a binary they produced themselves,
+ * the caller must treat a false load() as "compile from source" and save() afterwards.
+ *
+ * Each slot holds one entry: save() deletes whatever the slot held before, so shader edits and driver
+ * updates replace their binary instead of piling up next to it.
+ */
+class ProgramBinaryCache
+{
+public:
+    // Bump whenever the on-disk layout changes
+    static constexpr unsigned int kVersion = 2;
+    static constexpr const char* kCacheDirectory = "shadercache";
+
+    // Needs GL 4.1 / ARB_get_program_binary and at least one binary format exposed by the driver
+    static bool isSupported();
+
+    // Call before linking from source, otherwise some drivers won't hand the binary back
+    static void markRetrievable(unsigned int program);
+
+    // Returns true if the program was restored and linked successfully from the cache
+    // programName identifies the program independently of its source text, e.g. its files and defines
+    static bool load(unsigned int program, const std::string& programName, const std::string& vertexSource,
+                     const std::string& fragmentSource);
+    static bool save(unsigned int program, const std::string& programName, const std::string& vertexSource,
+                     const std::string& fragmentSource);
+
+private:
+    static const std::string& getDriverString();
+    static uint64_t getSlot(const std::string& programName);
+    static uint64_t getKey(const std::string& vertexSource, const std::string& fragmentSource);
+    static std::string getFileName(uint64_t slot, uint64_t key);
+    static void pruneSlot(const std::string& keepFileName);
+};
+
+#endif //PROGRAMBINARYCACHE_H
@@ -2,36 +2,189 @@
 #include "Shader.h"
 
 #include <fstream>
-#include <iostream>
-#include <ostream>
 #include <sstream>
 #include <GL/glew.h>
 #include <glm/gtc/type_ptr.hpp>
 #include "Renderer.h"
+#include "FrameUniforms.h"
+#include "ProgramBinaryCache.h"
+#include "Logger.h"
 
+namespace
+{
+    bool IsSamplerType(GLenum type)
+    {
+        switch (type) {
+            case GL_SAMPLER_2D:
+            case GL_SAMPLER_3D:
+            case GL_SAMPLER_CUBE:
+            case GL_SAMPLER_2D_SHADOW:
+            case GL_SAMPLER_2D_ARRAY:
+            case GL_SAMPLER_2D_ARRAY_SHADOW:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    // Which GL uniform types a UniformHandle<T> may point at
+    template <typename T>
+    struct UniformTypeTraits;
+
+    template <>
+    struct UniformTypeTraits<int>
+    {
+        static constexpr const char* kName = "int";
+        static bool accepts(GLenum type) { return type == GL_INT || type == GL_BOOL || IsSamplerType(type); }
+    };
+
+    template <>
+    struct UniformTypeTraits<float>
+    {
+        static constexpr const char* kName = "float";
+        static bool accepts(GLenum type) { return type == GL_FLOAT; }
+    };
+
+    template <>
+    struct UniformTypeTraits<glm::vec2>
+    {
+        static constexpr const char* kName = "vec2";
+        static bool accepts(GLenum type) { return type == GL_FLOAT_VEC2; }
+    };
+
+    template <>
+    struct UniformTypeTraits<glm::vec3>
+    {
+        static constexpr const char* kName = "vec3";
+        static bool accepts(GLenum type) { return type == GL_FLOAT_VEC3; }
+    };
+
+    template <>
+    struct UniformTypeTraits<glm::vec4>
+    {
+        static constexpr const char* kName = "vec4";
+        static bool accepts(GLenum type) { return type == GL_FLOAT_VEC4; }
+    };
+
+    template <>
+    struct UniformTypeTraits<glm::mat4>
+    {
+        static constexpr const char* kName = "mat4";
+        static bool accepts(GLenum type) { return type == GL_FLOAT_MAT4; }
+    };
+}
 
-Shader::Shader(const std::string& vs_filepath, const std::string& fs_filepath)
-    : m_VSFilePath(vs_filepath), m_FSFilePath(fs_filepath)
+Shader::Shader(const std::string& vs_filepath, const std::string& fs_filepath, const std::string& defines)
+    : m_VSFilePath(vs_filepath), m_FSFilePath(fs_filepath), m_defines(defines)
 {
 
-    ShaderProgramSource source;
-    source.FragmentSource = ParseShader(shaderDir + fs_filepath);
-    std::cout << "Fragment Shader path: " << shaderDir + fs_filepath << std::endl;
-    source.VertexSource = ParseShader(shaderDir +  vs_filepath);
-    std::cout << "Vertex Shader path: " << shaderDir + vs_filepath << std::endl;
-    m_shaderID = CreateShader(source.VertexSource, source.FragmentSource);
+    m_fragmentSource = ParseShader(shaderDir + fs_filepath);
+    LOG_DEBUG(Shader, "Fragment shader path: " << shaderDir + fs_filepath);
+    m_vertexSource = ParseShader(shaderDir +  vs_filepath);
+    LOG_DEBUG(Shader, "Vertex shader path: " << shaderDir + vs_filepath);
+    InsertDefines(m_vertexSource, m_defines);
+    InsertDefines(m_fragmentSource, m_defines);
+
+    m_shaderID = glCreateProgram();
+    if (ProgramBinaryCache::load(m_shaderID, GetCacheName(), m_vertexSource, m_fragmentSource)) {
+        m_loadedFromBinary = true;
+        m_vertexSource.clear();
+        m_fragmentSource.clear();
+        OnLinked();
+        return;
+    }
+
+    // a rejected binary can leave the program in an odd state, start again from a fresh object
+    glDeleteProgram(m_shaderID);
+    m_shaderID = glCreateProgram();
+    StartLink();
 
 }
 
 Shader::~Shader()
 {
+    if (m_vertexShaderID != 0)
+        glDeleteShader(m_vertexShaderID);
+    if (m_fragmentShaderID != 0)
+        glDeleteShader(m_fragmentShaderID);
     glDeleteProgram(m_shaderID);
 }
 
+void Shader::StartLink()
+{
+    m_vertexShaderID = CompileShader(GL_VERTEX_SHADER, m_vertexSource);
+    m_fragmentShaderID = CompileShader(GL_FRAGMENT_SHADER, m_fragmentSource);
+
+    glAttachShader(m_shaderID, m_vertexShaderID);
+    glAttachShader(m_shaderID, m_fragmentShaderID);
+    ProgramBinaryCache::markRetrievable(m_shaderID);
+    glLinkProgram(m_shaderID);
+    m_linkPending = true;
+}
+
+bool Shader::IsLinkComplete() const
+{
+    if (!m_linkPending)
+        return true;
+    if (!GLEW_KHR_parallel_shader_compile && !GLEW_ARB_parallel_shader_compile)
+        return true;
+    int complete = GL_FALSE;
+    glGetProgramiv(m_shaderID, GL_COMPLETION_STATUS_KHR, &complete);
+    return complete == GL_TRUE;
+}
+
+bool Shader::FinishLink()
+{
+    if (!m_linkPending)
+        return m_linked;
+    m_linkPending = false;
+
+    // checking both stages first gives the useful error, a failed link after that is just the consequence
+    const bool vertexCompiled = CheckCompileStatus(m_vertexShaderID, GL_VERTEX_SHADER);
+    const bool fragmentCompiled = CheckCompileStatus(m_fragmentShaderID, GL_FRAGMENT_SHADER);
+
+    int linked = GL_FALSE;
+    glGetProgramiv(m_shaderID, GL_LINK_STATUS, &linked);
+    if (linked != GL_TRUE && vertexCompiled && fragmentCompiled) {
+        int length = 0;
+        glGetProgramiv(m_shaderID, GL_INFO_LOG_LENGTH, &length);
+        std::string message(static_cast<size_t>(length > 0 ? length : 1), '\0');
+        glGetProgramInfoLog(m_shaderID, length, &length, message.data());
+        LOG_ERROR(Shader, "Failed to link " << m_VSFilePath << " + " << m_FSFilePath);
+        std::istringstream lines(message.substr(0, static_cast<size_t>(length)));
+        for (std::string line; std::getline(lines, line);)
+            LOG_ERROR(Shader, line);
+    }
+
+    glDetachShader(m_shaderID, m_vertexShaderID);
+    glDetachShader(m_shaderID, m_fragmentShaderID);
+    glDeleteShader(m_vertexShaderID);
+    glDeleteShader(m_fragmentShaderID);
+    m_vertexShaderID = 0;
+    m_fragmentShaderID = 0;
+
+    if (linked == GL_TRUE) {
+        OnLinked();
+        ProgramBinaryCache::save(m_shaderID, GetCacheName(), m_vertexSource, m_fragmentSource);
+    }
+
+    m_vertexSource.clear();
+    m_fragmentSource.clear();
+    return m_linked;
+}
+
+void Shader::OnLinked()
+{
+    glValidateProgram(m_shaderID);
+    // block bindings and uniform values aren't part of a program binary, so this runs for both paths
+    FrameUniforms::BindBlocks(m_shaderID);
+    ReflectUniforms();
+    m_linked = true;
+}
+
 void Shader::Bind() const
 {
     glUseProgram(m_shaderID);
-    std::cout << "Shader ID we bound: " << m_shaderID << std::endl;
 }
 
 void Shader::Unbind() const
@@ -85,6 +238,112 @@ void Shader::SetUniform1f(const std::string& name, float value)
     glUniform1f(GetUniformLocation(name), value);
 }
 
+template <typename T>
+UniformHandle<T> Shader::GetUniformHandle(const std::string& name) const
+{
+    // a missing uniform is normal (compiled out, or a variant that doesn't use it), so only trace it
+    const int index = FindUniform(name);
+    if (index < 0) {
+        LOG_TRACE(Shader, "Uniform '" << name << "' doesn't exist, handle left invalid");
+        return {};
+    }
+    if (!UniformTypeTraits<T>::accepts(m_uniforms[index].type)) {
+        LOG_WARNING(Shader, "Uniform '" << name << "' is not a " << UniformTypeTraits<T>::kName);
+        return {};
+    }
+    return UniformHandle<T>{index};
+}
+
+template UniformHandle<int> Shader::GetUniformHandle<int>(const std::string& name) const;
+template UniformHandle<float> Shader::GetUniformHandle<float>(const std::string& name) const;
+template UniformHandle<glm::vec2> Shader::GetUniformHandle<glm::vec2>(const std::string& name) const;
+template UniformHandle<glm::vec3> Shader::GetUniformHandle<glm::vec3>(const std::string& name) const;
+template UniformHandle<glm::vec4> Shader::GetUniformHandle<glm::vec4>(const std::string& name) const;
+template UniformHandle<glm::mat4> Shader::GetUniformHandle<glm::mat4>(const std::string& name) const;
+
+void Shader::SetUniform(UniformHandle<int> handle, int value) const
+{
+    if (handle.isValid())
+        glUniform1i(m_uniforms[handle.index].location, value);
+}
+
+void Shader::SetUniform(UniformHandle<float> handle, float value) const
+{
+    if (handle.isValid())
+        glUniform1f(m_uniforms[handle.index].location, value);
+}
+
+void Shader::SetUniform(UniformHandle<glm::vec2> handle, const glm::vec2& value) const
+{
+    if (handle.isValid())
+        glUniform2f(m_uniforms[handle.index].location, value.x, value.y);
+}
+
+void Shader::SetUniform(UniformHandle<glm::vec3> handle, const glm::vec3& value) const
+{
+    if (handle.isValid())
+        glUniform3f(m_uniforms[handle.index].location, value.x, value.y, value.z);
+}
+
+void Shader::SetUniform(UniformHandle<glm::vec4> handle, const glm::vec4& value) const
+{
+    if (handle.isValid())
+        glUniform4f(m_uniforms[handle.index].location, value.x, value.y, value.z, value.w);
+}
+
+void Shader::SetUniform(UniformHandle<glm::mat4> handle, const glm::mat4& matrix) const
+{
+    if (handle.isValid())
+        glUniformMatrix4fv(m_uniforms[handle.index].location, 1, GL_FALSE, &matrix[0][0]);
+}
+
+/**
+ * Enumerates the program's active uniforms into m_uniforms. Uniform block members are skipped, they
+ * have no location and are fed through FrameUniforms instead.
+ */
+void Shader::ReflectUniforms()
+{
+    m_uniforms.clear();
+    m_UniformLocationCache.clear();
+
+    GLint count = 0, maxLength = 0;
+    glGetProgramiv(m_shaderID, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(m_shaderID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+    std::string name(static_cast<size_t>(maxLength > 0 ? maxLength : 1), '\0');
+    for (GLint i = 0; i < count; i++) {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(m_shaderID, static_cast<GLuint>(i), maxLength, &length, &size, &type, name.data());
+
+        std::string uniformName(name.data(), static_cast<size_t>(length));
+        const int location = glGetUniformLocation(m_shaderID, uniformName.c_str());
+        if (location == -1)
+            continue;
+
+        // seed the string path too so the SetUniform*(name) calls never have to ask GL
+        m_UniformLocationCache[uniformName] = location;
+        if (uniformName.size() > 3 && uniformName.compare(uniformName.size() - 3, 3, "[0]") == 0) {
+            uniformName.resize(uniformName.size() - 3);
+            m_UniformLocationCache[uniformName] = location;
+        }
+        m_uniforms.push_back({uniformName, location, type, size});
+    }
+}
+
+int Shader::FindUniform(const std::string& name) const
+{
+    // only runs when a handle is resolved, the table is a handful of entries
+    const bool firstElement = name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0;
+    const size_t length = firstElement ? name.size() - 3 : name.size();
+    for (size_t i = 0; i < m_uniforms.size(); i++) {
+        if (m_uniforms[i].name.compare(0, std::string::npos, name, 0, length) == 0)
+            return static_cast<int>(i);
+    }
+    return -1;
+}
+
 int Shader::GetUniformLocation(const std::string& name)
 {
 
@@ -96,7 +355,7 @@ int Shader::GetUniformLocation(const std::string& name)
     int location = glGetUniformLocation(m_shaderID, name.c_str());
     if(location == -1)
     {
-        std::cout << "Warning: uniform '" << name << "' doesn't exist!" << std::endl;
+        LOG_WARNING(Shader, "Uniform '" << name << "' doesn't exist!");
     }
     m_UniformLocationCache[name] = location;
 
@@ -110,7 +369,11 @@ unsigned int Shader::CompileShader(unsigned int type, const std::string& source)
     const char* src = source.c_str();
     glShaderSource(id, 1, &src, nullptr);
     glCompileShader(id);
+    return id;
+}
 
+bool Shader::CheckCompileStatus(unsigned int id, unsigned int type)
+{
     int result;
     glGetShaderiv(id, GL_COMPILE_STATUS, &result);
     if(result == GL_FALSE)
@@ -119,41 +382,42 @@ unsigned int Shader::CompileShader(unsigned int type, const std::string& source)
         glGetShaderiv(id, GL_INFO_LOG_LENGTH, &length);
         char* message = (char*)alloca(length * sizeof(char));
         glGetShaderInfoLog(id, length, &length, message);
-        std::cout << "Failed to compile " << (type == GL_VERTEX_SHADER ? "vertex" : "fragment") << " shader!" << std::endl;
-        std::cout << message << std::endl;
-        glDeleteShader(id);
-        return 0;
+        LOG_ERROR(Shader, "Failed to compile " << (type == GL_VERTEX_SHADER ? "vertex" : "fragment") << " shader!");
+        // one entry per line so a long info log isn't cut off by the logger's message limit
+        std::istringstream lines(message);
+        for (std::string line; std::getline(lines, line);)
+            LOG_ERROR(Shader, line);
+        return false;
     }
 
-    return id;
+    return true;
 }
 
-unsigned int Shader::CreateShader(const std::string& vertexShader, const std::string& fragmentShader)
+void Shader::InsertDefines(std::string& source, const std::string& defines)
 {
-    unsigned int program = glCreateProgram();
-    unsigned int vs = CompileShader(GL_VERTEX_SHADER, vertexShader);
-    unsigned int fs = CompileShader(GL_FRAGMENT_SHADER, fragmentShader);
-
-    glAttachShader(program, vs);
-    glAttachShader(program, fs);
-    glLinkProgram(program);
-    glValidateProgram(program);
-
-    glDeleteShader(vs);
-    glDeleteShader(fs);
-
-    return program;
+    if (defines.empty())
+        return;
+    // #version has to stay the first statement, so the defines go on the line after it
+    size_t insertAt = 0;
+    const size_t version = source.find("#version");
+    if (version != std::string::npos) {
+        const size_t lineEnd = source.find('\n', version);
+        insertAt = lineEnd == std::string::npos ? source.size() : lineEnd + 1;
+    }
+    source.insert(insertAt, defines);
 }
 
 std::string Shader::ParseShader(const std::string& filepath)
 {
-    std::ifstream file(filepath);
-    std::string str;
-    std::string shader;
-    while (std::getline(file, str)) {
-        shader.append(str + "\n");
+    // one read of the whole file, the source hash for the binary cache is taken over exactly these bytes
+    std::ifstream file(filepath, std::ios::binary);
+    if (!file.is_open()) {
+        LOG_ERROR(Shader, "Failed to open shader source: " << filepath);
+        return {};
     }
-    return shader;
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
 }
 
 
@@ -6,6 +6,7 @@
 #define SHADER_H
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include <glm/fwd.hpp>
 
 struct ShaderProgramSource
@@ -15,17 +16,63 @@ struct ShaderProgramSource
 
 };
 
+/**
+ * @brief Typed index into a Shader's reflected uniform table.
+ *
+ * Resolve once with Shader::GetUniformHandle<T>() (e.g. when a pass picks its program) and reuse it for
+ * every draw, setting through a handle is an array lookup with no hashing or string building. A handle
+ * is only meaningful for the shader that produced it; an invalid one (unknown name or mismatched type)
+ * makes the set a no-op, like location -1 does in GL.
+ */
+template <typename T>
+struct UniformHandle
+{
+    int index = -1;
+
+    [[nodiscard]] bool isValid() const { return index >= 0; }
+};
+
 class Shader
 {
 private:
+    // One entry per active default-block uniform, filled by ReflectUniforms() after linking
+    struct UniformInfo
+    {
+        std::string name; // arrays are stored under their base name, without "[0]"
+        int location;
+        unsigned int type;
+        int size;
+    };
+
     std::string m_VSFilePath;
     std::string m_FSFilePath;
+    std::string m_defines;
     unsigned int m_shaderID;
+    std::vector<UniformInfo> m_uniforms;
+
+    // Sources and stage objects are only held between starting a link and FinishLink()
+    std::string m_vertexSource;
+    std::string m_fragmentSource;
+    unsigned int m_vertexShaderID = 0;
+    unsigned int m_fragmentShaderID = 0;
+    bool m_linkPending = false;
+    bool m_linked = false;
+    bool m_loadedFromBinary = false;
     std::unordered_map<std::string, int> m_UniformLocationCache;
 public:
-    Shader::Shader(const std::string& vs_filepath, const std::string& fs_filepath);
+    // defines are inserted right after each stage's #version line (see ShaderVariant.h)
+    Shader::Shader(const std::string& vs_filepath, const std::string& fs_filepath, const std::string& defines = "");
     ~Shader();
 
+    // The constructor only kicks the compile and link off. The first status query blocks, so it is left
+    // to FinishLink(), which lets the driver build several programs at once (KHR_parallel_shader_compile).
+    // ShaderManager calls it before handing the shader out. Returns false if the program failed to link.
+    bool FinishLink();
+    // Non-blocking: true once FinishLink() would return without waiting (always true without the parallel extension)
+    [[nodiscard]] bool IsLinkComplete() const;
+    [[nodiscard]] bool IsLinked() const { return m_linked; }
+    [[nodiscard]] bool WasLoadedFromBinary() const { return m_loadedFromBinary; }
+
     void Bind() const;
     void Unbind() const;
 
@@ -36,16 +83,37 @@ public:
     void SetUniform4f(const std::string& name, float v0, float v1, float v2, float v3);
     void SetUniformMat4f(const std::string& name, const glm::mat4& matrix);
 
+    // Supported types: int (also samplers and bools), float, glm::vec2/3/4 and glm::mat4
+    template <typename T>
+    UniformHandle<T> GetUniformHandle(const std::string& name) const;
+
+    void SetUniform(UniformHandle<int> handle, int value) const;
+    void SetUniform(UniformHandle<float> handle, float value) const;
+    void SetUniform(UniformHandle<glm::vec2> handle, const glm::vec2& value) const;
+    void SetUniform(UniformHandle<glm::vec3> handle, const glm::vec3& value) const;
+    void SetUniform(UniformHandle<glm::vec4> handle, const glm::vec4& value) const;
+    void SetUniform(UniformHandle<glm::mat4> handle, const glm::mat4& matrix) const;
+
     unsigned int GetShaderID() const { return m_shaderID; }
+    const std::string& GetVertexPath() const { return m_VSFilePath; }
+    const std::string& GetFragmentPath() const { return m_FSFilePath; }
+    const std::string& GetDefines() const { return m_defines; }
 
     //TODO fix this - very dirty
-    std::string shaderDir = "source/Engine/Shaders/";
+    static inline const std::string shaderDir = "source/Engine/Shaders/";
 
 private:
     int GetUniformLocation(const std::string& name);
     unsigned int CompileShader(unsigned int type, const std::string& source);
-    unsigned int CreateShader(const std::string& vertexShader, const std::string& fragmentShader);
+    bool CheckCompileStatus(unsigned int id, unsigned int type);
+    void StartLink();
+    void OnLinked();
+    // Which program binary cache slot this program owns: its files and defines, not their contents
+    [[nodiscard]] std::string GetCacheName() const { return m_VSFilePath + "|" + m_FSFilePath + "|" + m_defines; }
+    void ReflectUniforms();
+    int FindUniform(const std::string& name) const;
     std::string ParseShader(const std::string& filepath);
+    static void InsertDefines(std::string& source, const std::string& defines);
 };
 
 
@@ -3,3 +3,226 @@
 //
 
 #include "ShaderManager.h"
+
+#include <algorithm>
+#include <GL/glew.h>
+
+#include "Logger.h"
+
+std::shared_ptr<Shader> ShaderManager::startShader(const std::string& vertexPath, const std::string& fragmentPath,
+                                                   const std::string& defines)
+{
+    // let the driver pick how many compiler threads to use, the builds then overlap until FinishLink()
+    if (!m_parallelCompileEnabled && GLEW_KHR_parallel_shader_compile)
+    {
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+        m_parallelCompileEnabled = true;
+    }
+    else if (!m_parallelCompileEnabled && GLEW_ARB_parallel_shader_compile)
+    {
+        glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+        m_parallelCompileEnabled = true;
+    }
+
+    return std::make_shared<Shader>(vertexPath, fragmentPath, defines);
+}
+
+void ShaderManager::loadShader(const std::string& shaderName, const std::string& vertexPath, const std::string& fragmentPath)
+{
+    auto shader = startShader(vertexPath, fragmentPath, m_globalDefines);
+    m_pending.push_back(shader);
+    m_shaders.emplace(shaderName, std::move(shader));
+}
+
+bool ShaderManager::finishLoading()
+{
+    bool allLinked = true;
+    for (auto& shader : m_pending)
+    {
+        const bool linked = shader->FinishLink();
+        if (linked && m_initializer)
+            m_initializer(*shader);
+        allLinked &= linked;
+    }
+    m_pending.clear();
+    return allLinked;
+}
+
+void ShaderManager::preloadVariant(const std::string& baseName, ShaderVariantKey key)
+{
+    auto& variants = m_variants[baseName];
+    for (const auto& variant : variants)
+    {
+        if (variant.key == key)
+            return;
+    }
+
+    const auto& base = m_shaders.at(baseName);
+    auto shader = startShader(base->GetVertexPath(), base->GetFragmentPath(), m_globalDefines + buildShaderDefines(key));
+    m_pending.push_back(shader);
+    variants.push_back({key, std::move(shader)});
+}
+
+const std::shared_ptr<Shader>& ShaderManager::getVariant(const std::string& baseName, ShaderVariantKey key)
+{
+    // a handful of variants per program at most, a linear scan beats a second hash
+    auto& variants = m_variants[baseName];
+    for (auto& variant : variants)
+    {
+        if (variant.key == key)
+        {
+            variant.shader->FinishLink();
+            return variant.shader;
+        }
+    }
+
+    LOG_DEBUG(Shader, "Building variant 0x" << std::hex << key << std::dec << " of " << baseName << " on demand");
+    const auto& base = m_shaders.at(baseName);
+    auto shader = startShader(base->GetVertexPath(), base->GetFragmentPath(), m_globalDefines + buildShaderDefines(key));
+    if (shader->FinishLink() && m_initializer)
+        m_initializer(*shader);
+    variants.push_back({key, std::move(shader)});
+    return variants.back().shader;
+}
+
+size_t ShaderManager::getVariantCount() const
+{
+    size_t count = 0;
+    for (const auto& entry : m_variants)
+        count += entry.second.size();
+    return count;
+}
+
+size_t ShaderManager::getBinaryCacheHits() const
+{
+    size_t hits = 0;
+    for (const auto& entry : m_shaders)
+        hits += entry.second->WasLoadedFromBinary() ? 1 : 0;
+    for (const auto& entry : m_variants)
+    {
+        for (const auto& variant : entry.second)
+            hits += variant.shader->WasLoadedFromBinary() ? 1 : 0;
+    }
+    return hits;
+}
+
+void ShaderManager::enableHotReload()
+{
+    if (m_watcher)
+        return;
+    m_watcher = std::make_unique<FileWatcher>(Shader::shaderDir);
+    if (!m_watcher->isWatching())
+    {
+        m_watcher.reset();
+        return;
+    }
+    LOG_INFO(Shader, "Watching " << Shader::shaderDir << " for shader changes");
+}
+
+size_t ShaderManager::update()
+{
+    if (!m_watcher)
+        return 0;
+
+    const auto now = std::chrono::steady_clock::now();
+    const size_t knownChanges = m_changedFiles.size();
+    m_watcher->poll(m_changedFiles);
+    if (m_changedFiles.size() != knownChanges)
+        m_lastChange = now;
+    if (!m_changedFiles.empty() && now - m_lastChange >= kReloadDelay)
+    {
+        startReloads();
+        m_changedFiles.clear();
+    }
+
+    size_t swapped = 0;
+    for (size_t i = 0; i < m_reloads.size();)
+    {
+        PendingReload& reload = m_reloads[i];
+        if (!reload.shader->IsLinkComplete())
+        {
+            i++;
+            continue;
+        }
+
+        if (reload.shader->FinishLink())
+        {
+            swapReloaded(reload);
+            swapped++;
+        }
+        else
+        {
+            LOG_ERROR(Shader, "Reload of " << reload.name << " failed, keeping the previous program");
+        }
+
+        m_reloads[i] = std::move(m_reloads.back());
+        m_reloads.pop_back();
+    }
+    return swapped;
+}
+
+void ShaderManager::swapReloaded(PendingReload& reload)
+{
+    std::shared_ptr<Shader>* slot = nullptr;
+    if (reload.isVariant)
+    {
+        for (auto& variant : m_variants[reload.name])
+        {
+            if (variant.key == reload.key)
+                slot = &variant.shader;
+        }
+    }
+    else
+    {
+        slot = &m_shaders[reload.name];
+    }
+    if (!slot)
+        return;
+
+    if (m_initializer)
+        m_initializer(*reload.shader);
+
+    // keep the old program alive until everyone has been told about the swap
+    std::shared_ptr<Shader> previous = std::move(*slot);
+    *slot = reload.shader;
+    if (m_onReloaded && previous)
+        m_onReloaded(reload.name, *previous, *reload.shader);
+    LOG_INFO(Shader, "Reloaded " << reload.name << (reload.isVariant ? " (variant)" : ""));
+}
+
+void ShaderManager::queueReload(const std::string& name, bool isVariant, ShaderVariantKey key, const Shader& shader)
+{
+    auto rebuilt = startShader(shader.GetVertexPath(), shader.GetFragmentPath(), shader.GetDefines());
+    // a newer edit supersedes a rebuild that is still in flight
+    auto inFlight = std::find_if(m_reloads.begin(), m_reloads.end(), [&](const PendingReload& reload) {
+        return reload.name == name && reload.isVariant == isVariant && reload.key == key;
+    });
+    if (inFlight != m_reloads.end())
+        inFlight->shader = std::move(rebuilt);
+    else
+        m_reloads.push_back({name, isVariant, key, std::move(rebuilt)});
+}
+
+void ShaderManager::startReloads()
+{
+    auto uses = [this](const Shader& shader) {
+        auto changed = [this](const std::string& path) {
+            return std::find(m_changedFiles.begin(), m_changedFiles.end(), path) != m_changedFiles.end();
+        };
+        return changed(shader.GetVertexPath()) || changed(shader.GetFragmentPath());
+    };
+
+    for (const auto& [name, shader] : m_shaders)
+    {
+        if (uses(*shader))
+            queueReload(name, false, 0, *shader);
+    }
+    for (const auto& [name, variants] : m_variants)
+    {
+        for (const auto& variant : variants)
+        {
+            if (uses(*variant.shader))
+                queueReload(name, true, variant.key, *variant.shader);
+        }
+    }
+}
@@ -4,23 +4,109 @@
 
 #ifndef SHADERMANAGER_H
 #define SHADERMANAGER_H
+#include <chrono>
+#include <functional>
 #include <memory>
 #include <Shader.h>
 #include <unordered_map>
+#include <vector>
+
+#include "FileWatcher.h"
+#include "ShaderVariant.h"
 
 
 class ShaderManager {
+public:
+    using ReloadCallback = std::function<void(const std::string& name, const Shader& oldShader, const Shader& newShader)>;
+    using ProgramInitializer = std::function<void(const Shader& shader)>;
+
 private:
+    struct Variant
+    {
+        ShaderVariantKey key;
+        std::shared_ptr<Shader> shader;
+    };
+
     std::unordered_map<std::string, std::shared_ptr<Shader>> m_shaders;
+    // feature permutations of the programs above, keyed by the base program's name
+    std::unordered_map<std::string, std::vector<Variant>> m_variants;
+    // programs whose link was started but hasn't been checked yet
+    std::vector<std::shared_ptr<Shader>> m_pending;
+    bool m_parallelCompileEnabled = false;
+    ProgramInitializer m_initializer;
+    std::string m_globalDefines;
+
+    // hot reload, see enableHotReload()
+    struct PendingReload
+    {
+        std::string name;
+        bool isVariant;
+        ShaderVariantKey key;
+        std::shared_ptr<Shader> shader;
+    };
+
+    std::unique_ptr<FileWatcher> m_watcher;
+    std::vector<std::string> m_changedFiles;
+    std::chrono::steady_clock::time_point m_lastChange;
+    std::vector<PendingReload> m_reloads;
+    ReloadCallback m_onReloaded;
+
+    std::shared_ptr<Shader> startShader(const std::string& vertexPath, const std::string& fragmentPath, const std::string& defines);
+    void queueReload(const std::string& name, bool isVariant, ShaderVariantKey key, const Shader& shader);
+    void startReloads();
+    void swapReloaded(PendingReload& reload);
 public:
+    // editors often write a file more than once per save, wait for them to go quiet before rebuilding
+    static constexpr auto kReloadDelay = std::chrono::milliseconds(100);
+
     std::shared_ptr<Shader> getShader(const std::string& shaderName) {
-        return m_shaders.at(shaderName);
+        auto& shader = m_shaders.at(shaderName);
+        shader->FinishLink();
+        return shader;
     }
 
-    void loadShader(const std::string& shaderName, const std::string& vertexPath, const std::string& fragmentPath)
-    {
-        m_shaders.emplace(shaderName, std::make_shared<Shader>(vertexPath, fragmentPath));
+    bool hasShader(const std::string& shaderName) const {
+        return m_shaders.find(shaderName) != m_shaders.end();
     }
+
+    // Starts the program building, call finishLoading() once every shader of a batch has been queued
+    void loadShader(const std::string& shaderName, const std::string& vertexPath, const std::string& fragmentPath);
+
+    // Waits for every queued program (including preloaded variants), returns false if any failed to link
+    bool finishLoading();
+
+    // Run on every program once it has linked (initial load, new variant, hot reload), e.g. to set sampler units.
+    // Set it before loading anything.
+    void setProgramInitializer(ProgramInitializer initializer) { m_initializer = std::move(initializer); }
+
+    // #defines every program and variant is built with ahead of its own (e.g. COMPACT_VERTEX).
+    // Set it before loading anything, hot reloads keep the defines a program was built with.
+    void setGlobalDefines(std::string defines) { m_globalDefines = std::move(defines); }
+
+    /*
+     * Variants: the base program's sources recompiled with buildShaderDefines(key). preloadVariant() queues
+     * one alongside the rest of a loading batch; getVariant() returns it, building it on the spot (and
+     * stalling) if nobody asked for it up front. The base program must already be loaded.
+     */
+    void preloadVariant(const std::string& baseName, ShaderVariantKey key);
+    const std::shared_ptr<Shader>& getVariant(const std::string& baseName, ShaderVariantKey key);
+    [[nodiscard]] size_t getVariantCount() const;
+
+    [[nodiscard]] bool isParallelCompileEnabled() const { return m_parallelCompileEnabled; }
+    [[nodiscard]] size_t getBinaryCacheHits() const;
+    [[nodiscard]] size_t getShaderCount() const { return m_shaders.size() + getVariantCount(); }
+
+    /*
+     * Hot reload: watch Shader::shaderDir and rebuild every program (and variant) that uses a file once it
+     * changes. The rebuild is started in update() and polled without blocking on later frames; only when it
+     * has linked does the program replace the old one (a failed edit keeps the old program and logs the
+     * error). Callers must look shaders up through getShader()/getVariant() each frame instead of holding
+     * on to the shared_ptr, and use the callback to drop anything keyed on the old program.
+     */
+    void enableHotReload();
+    void setReloadCallback(ReloadCallback callback) { m_onReloaded = std::move(callback); }
+    // Call once per frame on the GL thread, returns how many programs were swapped in
+    size_t update();
 };
 
 
@@ -0,0 +1,46 @@
+//
+// Created by Shaun on 17/10/2026.
+//
+
+#ifndef SHADERVARIANT_H
+#define SHADERVARIANT_H
+
+#include <cstdint>
+#include <string>
+
+/*
+ * A shader variant is the same pair of source files compiled with a different set of feature #defines.
+ * The key packs the on/off features into the low bits and the shadow filter level into bits 8-11, so
+ * it can be compared and hashed as a plain integer. Sources see every feature as a 0/1 (or level)
+ * value and must provide #ifndef defaults for the plain, non-variant program.
+ */
+using ShaderVariantKey = uint32_t;
+
+namespace ShaderFeature
+{
+    constexpr ShaderVariantKey NormalMap = 1u << 0; // HAS_NORMAL_MAP
+    constexpr ShaderVariantKey AlphaTest = 1u << 1; // ALPHA_TEST
+
+    // SHADOW_PCF_LEVEL: 0 = one hardware-filtered tap, 1 = 3x3 kernel, 2 = 5x5 kernel
+    constexpr unsigned int kPcfShift = 8;
+    constexpr ShaderVariantKey kPcfMask = 0xFu << kPcfShift;
+    constexpr unsigned int kMaxPcfLevel = 2;
+}
+
+constexpr ShaderVariantKey makeShaderVariant(ShaderVariantKey features, unsigned int pcfLevel)
+{
+    return (features & ~ShaderFeature::kPcfMask) |
+           ((pcfLevel > ShaderFeature::kMaxPcfLevel ? ShaderFeature::kMaxPcfLevel : pcfLevel) << ShaderFeature::kPcfShift);
+}
+
+// The #define block inserted after a variant's #version line
+inline std::string buildShaderDefines(ShaderVariantKey key)
+{
+    std::string defines;
+    defines += "#define HAS_NORMAL_MAP " + std::to_string((key & ShaderFeature::NormalMap) ? 1 : 0) + "\n";
+    defines += "#define ALPHA_TEST " + std::to_string((key & ShaderFeature::AlphaTest) ? 1 : 0) + "\n";
+    defines += "#define SHADOW_PCF_LEVEL " + std::to_string((key & ShaderFeature::kPcfMask) >> ShaderFeature::kPcfShift) + "\n";
+    return defines;
+}
+
+#endif //SHADERVARIANT_H
@@ -4,16 +4,29 @@
 in vec3 FragPos;
 in vec3 Normal;
 in vec2 TexCoords;
-in vec4 LightSpacePos;
+in float ViewDepth;
 in vec3 Tangent;     // Texture coordinates
 in vec3 BiTangent;     // Texture coordinates
 in mat3 TBN;
 
 layout(location = 0) out vec4 FragColor;
 
+// Feature switches, ShaderManager variants define these after #version (see ShaderVariant.h).
+// The defaults are the plain program with every feature on.
+#ifndef HAS_NORMAL_MAP
+#define HAS_NORMAL_MAP 1
+#endif
+#ifndef ALPHA_TEST
+#define ALPHA_TEST 0
+#endif
+#ifndef SHADOW_PCF_LEVEL
+#define SHADOW_PCF_LEVEL 1
+#endif
+
 uniform sampler2D albedoMap;
+#if HAS_NORMAL_MAP
 uniform sampler2D normalMap;
-uniform sampler2D roughnessMap;
+#endif
 
 struct Material {
     sampler2D diffuse;
@@ -32,31 +45,54 @@ struct DirectionalLight {
 };
 uniform Material material;
 uniform DirectionalLight dirLight;
-uniform vec3 viewPos;
+
+layout (std140) uniform CameraBlock {
+    mat4 view;       // View transformation matrix
+    mat4 projection; // Projection matrix
+    vec3 viewPos;
+};
+
+#define MAX_CASCADES 4
 
 // **New Uniform Added**
-uniform sampler2DShadow shadowMap;// Shadow map texture
-uniform vec2 gMapSize;
+uniform sampler2DArrayShadow shadowMap;// Shadow map texture, one layer per cascade
+
+layout (std140) uniform ShadowBlock {
+    mat4 cascadeMatrices[MAX_CASCADES];
+    vec4 cascadeSplits;  // View space distance where each cascade ends
+    vec2 gMapSize;       // Resolution of one cascade
+    int cascadeCount;
+};
 
 float shadowAmount = 0.7;
 
 const float kPi = 3.14159265;
 const float kShininess = 16.0;
 
-struct Light {
+layout (std140) uniform LightBlock {
     vec3 direction;
     vec3 position;
     vec3 ambient;
     vec3 diffuse;
     vec3 specular;
-};
-
-uniform Light light;
+} light;
 
 #define EPSILON 0.00001
 
-float CalcShadowFactor(vec4 LightSpacePos)
+float CalcShadowFactor(vec3 worldPos)
 {
+    // first cascade that reaches this far, anything past the last split uses the last cascade
+    int cascade = cascadeCount - 1;
+    for (int i = 0; i < cascadeCount; i++)
+    {
+        if (ViewDepth < cascadeSplits[i])
+        {
+            cascade = i;
+            break;
+        }
+    }
+
+    vec4 LightSpacePos = cascadeMatrices[cascade] * vec4(worldPos, 1.0);
     vec3 projCoords = LightSpacePos.xyz / LightSpacePos.w;
     projCoords = projCoords * 0.5 + 0.5;
 
@@ -66,37 +102,58 @@ float CalcShadowFactor(vec4 LightSpacePos)
     vec3 lightDir = normalize(-light.direction);
     float bias = max(0.0025 * (1.0 - dot(Normal, lightDir)), 0.0005);
 
+#if SHADOW_PCF_LEVEL == 0
+    // single tap, the comparison sampler still gives 2x2 hardware filtering
+    return texture(shadowMap, vec4(projCoords.xy, float(cascade), projCoords.z - bias));
+#else
     float shadow = 0.0;
-    int samples = 3;
     float texelSizeX = 1.0 / gMapSize.x;
     float texelSizeY = 1.0 / gMapSize.y;
 
+#if SHADOW_PCF_LEVEL == 1
     // Gaussian weights for smoother shadows
+    const int kRadius = 1;
     float weights[3] = float[](0.25, 0.5, 0.25);
+#else
+    const int kRadius = 2;
+    float weights[5] = float[](0.0625, 0.25, 0.375, 0.25, 0.0625);
+#endif
 
-    for (int y = -1; y <= 1; y++)
+    for (int y = -kRadius; y <= kRadius; y++)
     {
-        for (int x = -1; x <= 1; x++)
+        for (int x = -kRadius; x <= kRadius; x++)
         {
             vec2 offset = vec2(x * texelSizeX, y * texelSizeY);
-            float weight = weights[x + 1] * weights[y + 1];
+            float weight = weights[x + kRadius] * weights[y + kRadius];
             // **Adjusted bias direction**
-            shadow += texture(shadowMap, vec3(projCoords.xy + offset, projCoords.z - bias)) * weight;
+            shadow += texture(shadowMap, vec4(projCoords.xy + offset, float(cascade), projCoords.z - bias)) * weight;
         }
     }
 
     return shadow;
+#endif
 }
 
 void main() {
 
+    vec4 albedo = texture(albedoMap, TexCoords);
+#if ALPHA_TEST
+    if (albedo.a < 0.5)
+        discard;
+#endif
 
-    vec3 normal = texture(normalMap, TexCoords).rgb;
-    normal = normalize(normal * 2.0 - 1.0); // Convert normal from [0, 1] to [-1, 1]
+#if HAS_NORMAL_MAP
+    vec3 normal;
+    normal.xy = texture(normalMap, TexCoords).rg * 2.0 - 1.0; // Convert normal from [0, 1] to [-1, 1]
     normal.y = -normal.y; // Flip Y-channel to fix inverted normals
+    // Z is rebuilt instead of sampled so baked two channel (BC5) normal maps shade the same as RGB ones
+    normal.z = sqrt(max(1.0 - dot(normal.xy, normal.xy), 0.0));
+    normal = normalize(normal);
     vec3 transformedNormal = normalize(TBN * normal);
-
-    float roughness = texture(roughnessMap, TexCoords).r;
+#else
+    // flat tangent space normal
+    vec3 transformedNormal = normalize(TBN * vec3(0.0, 0.0, 1.0));
+#endif
 
 
     vec3 lightDir;
@@ -117,11 +174,11 @@ void main() {
      */
 
     // ambient lighting
-    vec3 ambient = light.ambient * vec3(texture(albedoMap, TexCoords));
+    vec3 ambient = light.ambient * albedo.rgb;
 
     // diffuse lighting
     float diff = max(dot(transformedNormal, tangentLightDir), 0.0);
-    vec3 diffuse = light.diffuse * diff * vec3(texture(albedoMap, TexCoords));
+    vec3 diffuse = light.diffuse * diff * albedo.rgb;
 
 
     vec3 viewDir = normalize(viewPos - FragPos);
@@ -134,14 +191,14 @@ void main() {
 
     vec3 specular = light.specular * spec;
 
-    float shadow = CalcShadowFactor(LightSpacePos);
+    float shadow = CalcShadowFactor(FragPos);
     vec3 lighting = ambient + shadow * (diffuse + specular);
 
 //    FragColor = vec4(transformedNormal * 0.5 + 0.5, 1.0); // Visualize normals
 //    FragColor = vec4(tangentLightDir * 0.5 + 0.5, 1.0);   // Visualize light direction
 
     // Shadow debug visualization
-//    FragColor = vec4(vec3(CalcShadowFactor(LightSpacePos)), 1.0);
+//    FragColor = vec4(vec3(CalcShadowFactor(FragPos)), 1.0);
 
     // Lit view
     FragColor = vec4(lighting, 1.0);
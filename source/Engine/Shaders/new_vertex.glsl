@@ -1,26 +1,59 @@
 #version 410 core
 
+#ifndef COMPACT_VERTEX
+#define COMPACT_VERTEX 0
+#endif
+
+#if COMPACT_VERTEX
+// CompactVertex, see CompactVertex.h
+layout (location = 0) in vec4 aPackedPos;     // Position in the mesh bounds, w = bitangent sign
+layout (location = 1) in vec2 aPackedNormal;  // Octahedral normal
+layout (location = 2) in vec2 aTexCoords;     // Texture coordinates
+layout (location = 3) in vec2 aPackedTangent; // Octahedral tangent
+
+uniform vec3 positionOffset; // MeshComponent dequantization
+uniform vec3 positionScale;
+
+// Octahedral encoded unit vector back to 3D (CompactVertexPacking::octEncode)
+vec3 octDecode(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.xy += mix(vec2(t), vec2(-t), greaterThanEqual(n.xy, vec2(0.0)));
+    return normalize(n);
+}
+#else
 layout (location = 0) in vec3 aPos;       // Position
 layout (location = 1) in vec3 aNormal;    // Normal
 layout (location = 2) in vec2 aTexCoords; // Texture coordinates
 layout (location = 3) in vec3 aTangent; // Texture coordinates
 layout (location = 4) in vec3 aBiTangent; // Texture coordinates
+#endif
 
 out vec3 FragPos;       // Fragment position in world space
 out vec3 Normal;        // Normal vector for lighting
 out vec2 TexCoords;     // Texture coordinates
-out vec4 LightSpacePos;    // Position transformed into light space
+out float ViewDepth;     // View space depth, picks the shadow cascade
 out vec3 Tangent;     // Texture coordinates
 out vec3 BiTangent;     // Texture coordinates
 out mat3 TBN;
 
-uniform mat4 lightSpaceMatrix;  // Matrix to transform positions into light space
 uniform mat4 model;      // Model transformation matrix
-uniform mat4 view;       // View transformation matrix
-uniform mat4 projection; // Projection matrix
+layout (std140) uniform CameraBlock {
+    mat4 view;       // View transformation matrix
+    mat4 projection; // Projection matrix
+    vec3 viewPos;
+};
 
 void main()
 {
+#if COMPACT_VERTEX
+    vec3 aPos = aPackedPos.xyz * positionScale + positionOffset;
+    vec3 aNormal = octDecode(aPackedNormal);
+    vec3 aTangent = octDecode(aPackedTangent);
+    vec3 aBiTangent = (aPackedPos.w * 2.0 - 1.0) * cross(aNormal, aTangent);
+#endif
+
     vec3 T = normalize(vec3(model * vec4(aTangent, 0.0)));
     vec3 B = normalize(vec3(model * vec4(aBiTangent, 0.0)));
     vec3 N = normalize(vec3(model * vec4(aNormal, 0.0)));
@@ -30,8 +63,9 @@ void main()
     Normal = mat3(transpose(inverse(model))) * aNormal; // Correct normal for model transformations
     TexCoords = aTexCoords;
 
-    // shadow mapping
-    LightSpacePos = lightSpaceMatrix * vec4(FragPos, 1.0);
+    vec4 viewPosition = view * vec4(FragPos, 1.0);
+    // shadow mapping, the fragment shader picks the cascade from this
+    ViewDepth = -viewPosition.z;
 
-    gl_Position = projection * view * vec4(FragPos, 1.0); // Final vertex position
+    gl_Position = projection * viewPosition; // Final vertex position
 }
@@ -0,0 +1,81 @@
+#version 430 core
+
+// Multi-draw-indirect variant of new_vertex.glsl, the model matrix comes from the per-draw SSBO
+
+#ifndef COMPACT_VERTEX
+#define COMPACT_VERTEX 0
+#endif
+
+#if COMPACT_VERTEX
+// CompactVertex, see CompactVertex.h
+layout (location = 0) in vec4 aPackedPos;     // Position in the mesh bounds, w = bitangent sign
+layout (location = 1) in vec2 aPackedNormal;  // Octahedral normal
+layout (location = 2) in vec2 aTexCoords;     // Texture coordinates
+layout (location = 3) in vec2 aPackedTangent; // Octahedral tangent
+
+// Octahedral encoded unit vector back to 3D (CompactVertexPacking::octEncode)
+vec3 octDecode(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.xy += mix(vec2(t), vec2(-t), greaterThanEqual(n.xy, vec2(0.0)));
+    return normalize(n);
+}
+#else
+layout (location = 0) in vec3 aPos;       // Position
+layout (location = 1) in vec3 aNormal;    // Normal
+layout (location = 2) in vec2 aTexCoords; // Texture coordinates
+layout (location = 3) in vec3 aTangent; // Texture coordinates
+layout (location = 4) in vec3 aBiTangent; // Texture coordinates
+#endif
+layout (location = 5) in uint aDrawID;    // Per-draw index (instanced attribute offset by baseInstance)
+
+struct DrawData {
+    mat4 model;
+    vec4 positionOffset; // MeshComponent dequantization, xyz used
+    vec4 positionScale;
+};
+
+layout (std430, binding = 0) readonly buffer DrawDataBuffer {
+    DrawData draws[];
+};
+
+out vec3 FragPos;       // Fragment position in world space
+out vec3 Normal;        // Normal vector for lighting
+out vec2 TexCoords;     // Texture coordinates
+out float ViewDepth;     // View space depth, picks the shadow cascade
+out vec3 Tangent;     // Texture coordinates
+out vec3 BiTangent;     // Texture coordinates
+out mat3 TBN;
+
+layout (std140) uniform CameraBlock {
+    mat4 view;       // View transformation matrix
+    mat4 projection; // Projection matrix
+    vec3 viewPos;
+};
+
+void main()
+{
+    mat4 model = draws[aDrawID].model;
+#if COMPACT_VERTEX
+    vec3 aPos = aPackedPos.xyz * draws[aDrawID].positionScale.xyz + draws[aDrawID].positionOffset.xyz;
+    vec3 aNormal = octDecode(aPackedNormal);
+    vec3 aTangent = octDecode(aPackedTangent);
+    vec3 aBiTangent = (aPackedPos.w * 2.0 - 1.0) * cross(aNormal, aTangent);
+#endif
+
+    vec3 T = normalize(vec3(model * vec4(aTangent, 0.0)));
+    vec3 B = normalize(vec3(model * vec4(aBiTangent, 0.0)));
+    vec3 N = normalize(vec3(model * vec4(aNormal, 0.0)));
+    TBN = mat3(T, B, N);
+
+    FragPos = vec3(model * vec4(aPos, 1.0)); // Transform vertex position to world space
+    Normal = mat3(transpose(inverse(model))) * aNormal; // Correct normal for model transformations
+    TexCoords = aTexCoords;
+
+    vec4 viewPosition = view * vec4(FragPos, 1.0);
+    // shadow mapping, the fragment shader picks the cascade from this
+    ViewDepth = -viewPosition.z;
+
+    gl_Position = projection * viewPosition; // Final vertex position
+}
@@ -1,11 +1,33 @@
 #version 410 core
 
+#ifndef COMPACT_VERTEX
+#define COMPACT_VERTEX 0
+#endif
+
+#if COMPACT_VERTEX
+layout (location = 0) in vec4 aPackedPos; // Position in the mesh bounds
+uniform vec3 positionOffset;
+uniform vec3 positionScale;
+#else
 layout (location = 0) in vec3 aPos;
+#endif
+
+#define MAX_CASCADES 4
+
+layout (std140) uniform ShadowBlock {
+    mat4 cascadeMatrices[MAX_CASCADES];
+    vec4 cascadeSplits;  // View space distance where each cascade ends
+    vec2 gMapSize;       // Resolution of one cascade
+    int cascadeCount;
+};
 
-uniform mat4 lightSpaceMatrix;
+uniform int cascadeIndex; // cascade being rendered
 uniform mat4 model;
 
 void main()
 {
-    gl_Position = lightSpaceMatrix * model * vec4(aPos, 1.0);
+#if COMPACT_VERTEX
+    vec3 aPos = aPackedPos.xyz * positionScale + positionOffset;
+#endif
+    gl_Position = cascadeMatrices[cascadeIndex] * model * vec4(aPos, 1.0);
 }
\ No newline at end of file
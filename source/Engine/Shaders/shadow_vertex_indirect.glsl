@@ -0,0 +1,41 @@
+#version 430 core
+
+#ifndef COMPACT_VERTEX
+#define COMPACT_VERTEX 0
+#endif
+
+#if COMPACT_VERTEX
+layout (location = 0) in vec4 aPackedPos; // Position in the mesh bounds
+#else
+layout (location = 0) in vec3 aPos;
+#endif
+layout (location = 5) in uint aDrawID;
+
+struct DrawData {
+    mat4 model;
+    vec4 positionOffset; // MeshComponent dequantization, xyz used
+    vec4 positionScale;
+};
+
+layout (std430, binding = 0) readonly buffer DrawDataBuffer {
+    DrawData draws[];
+};
+
+#define MAX_CASCADES 4
+
+layout (std140) uniform ShadowBlock {
+    mat4 cascadeMatrices[MAX_CASCADES];
+    vec4 cascadeSplits;  // View space distance where each cascade ends
+    vec2 gMapSize;       // Resolution of one cascade
+    int cascadeCount;
+};
+
+uniform int cascadeIndex; // cascade being rendered
+
+void main()
+{
+#if COMPACT_VERTEX
+    vec3 aPos = aPackedPos.xyz * draws[aDrawID].positionScale.xyz + draws[aDrawID].positionOffset.xyz;
+#endif
+    gl_Position = cascadeMatrices[cascadeIndex] * draws[aDrawID].model * vec4(aPos, 1.0);
+}
@@ -0,0 +1,39 @@
+//
+// Created by Shaun on 17/10/2026.
+//
+
+#include "AtomicFile.h"
+
+#include <filesystem>
+#include <fstream>
+
+bool writeFileAtomically(const std::string& filePath, LogCategory category,
+                         const std::function<void(std::ostream&)>& writeContents)
+{
+    const std::string tempPath = filePath + ".tmp";
+    std::error_code error;
+    {
+        std::ofstream stream(tempPath, std::ios::binary | std::ios::trunc);
+        if (!stream.is_open()) {
+            ENGINE_LOG(LogLevel::Error, category, "Failed to open " << tempPath << " for writing");
+            return false;
+        }
+
+        writeContents(stream);
+
+        if (!stream.good()) {
+            ENGINE_LOG(LogLevel::Error, category, "Failed writing " << tempPath);
+            stream.close();
+            std::filesystem::remove(tempPath, error);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(tempPath, filePath, error);
+    if (error) {
+        ENGINE_LOG(LogLevel::Error, category, "Failed to replace " << filePath << ": " << error.message());
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+    return true;
+}
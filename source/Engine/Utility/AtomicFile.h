@@ -0,0 +1,23 @@
+//
+// Created by Shaun on 17/10/2026.
+//
+
+#ifndef ATOMICFILE_H
+#define ATOMICFILE_H
+
+#include <functional>
+#include <ostream>
+#include <string>
+
+#include "Logger.h"
+
+/*
+ * Writes filePath through a temporary file that is renamed over it once writeContents has finished
+ * and the stream is still good. The on-disk caches (meshes, program binaries, baked textures) only
+ * check a header before trusting the rest, so a crash or full disk mid-write must never leave a
+ * half written file behind under the real name. Failures are logged under category.
+ */
+bool writeFileAtomically(const std::string& filePath, LogCategory category,
+                         const std::function<void(std::ostream&)>& writeContents);
+
+#endif //ATOMICFILE_H
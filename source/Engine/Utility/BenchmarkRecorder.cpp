@@ -0,0 +1,188 @@
+//
+// Created by Shaun on 17/10/2026.
+//
+
+#include "BenchmarkRecorder.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+
+namespace
+{
+    struct Summary
+    {
+        double mean = 0.0, median = 0.0, p95 = 0.0, min = 0.0, max = 0.0;
+    };
+
+    Summary summarise(std::vector<double> values)
+    {
+        Summary summary;
+        if (values.empty())
+            return summary;
+
+        std::sort(values.begin(), values.end());
+        double total = 0.0;
+        for (double value : values)
+            total += value;
+
+        summary.mean = total / static_cast<double>(values.size());
+        summary.median = values[values.size() / 2];
+        summary.p95 = values[std::min(values.size() - 1, static_cast<size_t>(static_cast<double>(values.size()) * 0.95))];
+        summary.min = values.front();
+        summary.max = values.back();
+        return summary;
+    }
+
+    void writeSummary(std::ostream& out, const Summary& summary)
+    {
+        out << "{\"mean\": " << summary.mean << ", \"median\": " << summary.median << ", \"p95\": " << summary.p95
+            << ", \"min\": " << summary.min << ", \"max\": " << summary.max << "}";
+    }
+
+    std::string escape(const std::string& value)
+    {
+        std::string escaped;
+        for (char c : value) {
+            if (c == '"' || c == '\\') {
+                escaped += '\\';
+                escaped += c;
+            } else if (static_cast<unsigned char>(c) >= 0x20) {
+                escaped += c;
+            }
+        }
+        return escaped;
+    }
+}
+
+BenchmarkRecorder::~BenchmarkRecorder()
+{
+    for (auto& frame : m_frames) {
+        for (auto& pass : frame.passes) {
+            if (pass.query)
+                glDeleteQueries(1, &pass.query);
+        }
+    }
+}
+
+size_t BenchmarkRecorder::indexOf(std::vector<std::string>& names, const std::string& name)
+{
+    auto it = std::find(names.begin(), names.end(), name);
+    if (it != names.end())
+        return static_cast<size_t>(it - names.begin());
+    names.push_back(name);
+    return names.size() - 1;
+}
+
+void BenchmarkRecorder::beginFrame()
+{
+    m_frames.emplace_back();
+    m_frameStart = std::chrono::high_resolution_clock::now();
+}
+
+void BenchmarkRecorder::endFrame()
+{
+    m_frames.back().cpuMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - m_frameStart).count();
+}
+
+void BenchmarkRecorder::beginPass(const std::string& name)
+{
+    if (m_inPass) {
+        LOG_ERROR(Core, "BenchmarkRecorder: pass " << name << " started inside another pass");
+        endPass();
+    }
+
+    PassSample sample{indexOf(m_passNames, name), 0.0, 0};
+    glGenQueries(1, &sample.query);
+    glBeginQuery(GL_TIME_ELAPSED, sample.query);
+    m_frames.back().passes.push_back(sample);
+
+    m_inPass = true;
+    m_passStart = std::chrono::high_resolution_clock::now();
+}
+
+void BenchmarkRecorder::endPass()
+{
+    if (!m_inPass)
+        return;
+    m_frames.back().passes.back().cpuMs =
+        std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - m_passStart).count();
+    glEndQuery(GL_TIME_ELAPSED);
+    m_inPass = false;
+}
+
+void BenchmarkRecorder::setCounter(const std::string& name, double value)
+{
+    m_frames.back().counters.emplace_back(indexOf(m_counterNames, name), value);
+}
+
+bool BenchmarkRecorder::writeJson(const std::string& filePath)
+{
+    // everything has been submitted by now, waiting here doesn't skew any of the recorded numbers
+    glFinish();
+
+    std::vector<std::vector<double>> passCpu(m_passNames.size()), passGpu(m_passNames.size());
+    std::vector<std::vector<double>> counters(m_counterNames.size());
+    std::vector<double> frameCpu;
+    for (auto& frame : m_frames) {
+        frameCpu.push_back(frame.cpuMs);
+        for (auto& pass : frame.passes) {
+            GLuint64 elapsedNs = 0;
+            glGetQueryObjectui64v(pass.query, GL_QUERY_RESULT, &elapsedNs);
+            passCpu[pass.passIndex].push_back(pass.cpuMs);
+            passGpu[pass.passIndex].push_back(static_cast<double>(elapsedNs) / 1.0e6);
+        }
+        for (auto& counter : frame.counters)
+            counters[counter.first].push_back(counter.second);
+    }
+
+    std::ofstream out(filePath);
+    if (!out.is_open()) {
+        LOG_ERROR(Core, "BenchmarkRecorder: failed to open " << filePath);
+        return false;
+    }
+    out << std::fixed << std::setprecision(4);
+
+    out << "{\n  \"run\": {";
+    for (size_t i = 0; i < m_info.size(); i++)
+        out << (i ? ", " : "") << "\"" << escape(m_info[i].first) << "\": \"" << escape(m_info[i].second) << "\"";
+    out << "},\n  \"frames\": " << m_frames.size() << ",\n  \"frameCpuMs\": ";
+    writeSummary(out, summarise(frameCpu));
+
+    out << ",\n  \"passes\": {";
+    for (size_t i = 0; i < m_passNames.size(); i++) {
+        out << (i ? "," : "") << "\n    \"" << escape(m_passNames[i]) << "\": {\"cpuMs\": ";
+        writeSummary(out, summarise(passCpu[i]));
+        out << ", \"gpuMs\": ";
+        writeSummary(out, summarise(passGpu[i]));
+        out << "}";
+    }
+
+    out << "\n  },\n  \"counters\": {";
+    for (size_t i = 0; i < m_counterNames.size(); i++) {
+        out << (i ? "," : "") << "\n    \"" << escape(m_counterNames[i]) << "\": ";
+        writeSummary(out, summarise(counters[i]));
+    }
+
+    // raw per-frame numbers so regressions can be plotted, [cpuMs, gpuMs] per pass
+    out << "\n  },\n  \"perFrame\": [";
+    for (size_t f = 0; f < m_frames.size(); f++) {
+        out << (f ? "," : "") << "\n    {\"cpuMs\": " << frameCpu[f];
+        for (auto& pass : m_frames[f].passes) {
+            GLuint64 elapsedNs = 0;
+            glGetQueryObjectui64v(pass.query, GL_QUERY_RESULT, &elapsedNs);
+            out << ", \"" << escape(m_passNames[pass.passIndex]) << "\": [" << pass.cpuMs << ", "
+                << static_cast<double>(elapsedNs) / 1.0e6 << "]";
+        }
+        out << "}";
+    }
+    out << "\n  ]\n}\n";
+
+    if (!out.good()) {
+        LOG_ERROR(Core, "BenchmarkRecorder: failed writing " << filePath);
+        return false;
+    }
+    LOG_INFO(Core, "Benchmark results written to " << filePath << " (" << m_frames.size() << " frames)");
+    return true;
+}
@@ -0,0 +1,73 @@
+//
+// Created by Shaun on 17/10/2026.
+//
+
+#ifndef BENCHMARKRECORDER_H
+#define BENCHMARKRECORDER_H
+
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <GL/glew.h>
+
+/**
+ * @brief Collects per-pass CPU and GPU timings over a fixed number of frames and writes them as JSON.
+ *
+ * Passes are timed with a high resolution clock and a GL_TIME_ELAPSED query each. Queries are only
+ * read back in writeJson(), after the run, so recording never stalls the pipeline. GL_TIME_ELAPSED
+ * can't nest, so passes must not overlap.
+ */
+class BenchmarkRecorder
+{
+public:
+    BenchmarkRecorder() = default;
+    ~BenchmarkRecorder();
+
+    BenchmarkRecorder(const BenchmarkRecorder&) = delete;
+    BenchmarkRecorder& operator=(const BenchmarkRecorder&) = delete;
+
+    void beginFrame();
+    void endFrame();
+
+    void beginPass(const std::string& name);
+    void endPass();
+
+    // Per-frame value such as draw calls, reported as mean/min/max
+    void setCounter(const std::string& name, double value);
+
+    // Key/value pairs written to the "run" object (renderer string, resolution, ...)
+    void setInfo(const std::string& key, const std::string& value) { m_info.emplace_back(key, value); }
+
+    bool writeJson(const std::string& filePath);
+
+    [[nodiscard]] size_t getFrameCount() const { return m_frames.size(); }
+
+private:
+    struct PassSample
+    {
+        size_t passIndex;
+        double cpuMs;
+        GLuint query;
+    };
+
+    struct FrameSample
+    {
+        double cpuMs = 0.0;
+        std::vector<PassSample> passes;
+        std::vector<std::pair<size_t, double>> counters;
+    };
+
+    size_t indexOf(std::vector<std::string>& names, const std::string& name);
+
+    std::vector<std::string> m_passNames;
+    std::vector<std::string> m_counterNames;
+    std::vector<std::pair<std::string, std::string>> m_info;
+    std::vector<FrameSample> m_frames;
+
+    std::chrono::high_resolution_clock::time_point m_frameStart;
+    std::chrono::high_resolution_clock::time_point m_passStart;
+    bool m_inPass = false;
+};
+
+#endif //BENCHMARKRECORDER_H
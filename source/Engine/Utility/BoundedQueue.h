@@ -0,0 +1,90 @@
+//
+// Created by Shaun on 17/10/2026.
+//
+
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+
+/**
+ * @brief Fixed capacity multi-producer/multi-consumer queue.
+ *
+ * push() blocks while the queue is full, which is what throttles producers (e.g. image decoders)
+ * to the rate the consumer drains it. close() wakes everyone up and makes further pushes fail.
+ */
+template <typename T>
+class BoundedQueue
+{
+public:
+    explicit BoundedQueue(size_t capacity) : m_capacity(capacity > 0 ? capacity : 1) {}
+
+    // Returns false if the queue was closed while waiting
+    bool push(T value)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_notFull.wait(lock, [this]() { return m_closed || m_items.size() < m_capacity; });
+        if (m_closed)
+            return false;
+        m_items.push_back(std::move(value));
+        lock.unlock();
+        m_notEmpty.notify_one();
+        return true;
+    }
+
+    // Non-blocking, for consumers that must never stall (the GL thread)
+    bool tryPop(T& value)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_items.empty())
+            return false;
+        value = std::move(m_items.front());
+        m_items.pop_front();
+        lock.unlock();
+        m_notFull.notify_one();
+        return true;
+    }
+
+    // Blocks until an item is available, returns false once closed and drained
+    bool pop(T& value)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_notEmpty.wait(lock, [this]() { return m_closed || !m_items.empty(); });
+        if (m_items.empty())
+            return false;
+        value = std::move(m_items.front());
+        m_items.pop_front();
+        lock.unlock();
+        m_notFull.notify_one();
+        return true;
+    }
+
+    void close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_closed = true;
+        }
+        m_notFull.notify_all();
+        m_notEmpty.notify_all();
+    }
+
+    [[nodiscard]] size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_items.size();
+    }
+
+private:
+    std::deque<T> m_items;
+    size_t m_capacity;
+    bool m_closed = false;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_notFull;
+    std::condition_variable m_notEmpty;
+};
+
+#endif //BOUNDEDQUEUE_H
@@ -0,0 +1,117 @@
+//
+// Created by Shaun on 17/10/2026.
+//
+
+#include "FileWatcher.h"
+
+#include <algorithm>
+
+#include "Logger.h"
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+
+FileWatcher::FileWatcher(const std::string& directory) : m_directory(directory)
+{
+    m_inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_inotifyFd < 0) {
+        LOG_ERROR(Core, "FileWatcher: inotify_init1 failed: " << std::strerror(errno));
+        return;
+    }
+
+    // close-write covers in-place saves, moved-to covers editors that write a temp file and rename it over
+    if (inotify_add_watch(m_inotifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        LOG_ERROR(Core, "FileWatcher: failed to watch " << directory << ": " << std::strerror(errno));
+        close(m_inotifyFd);
+        m_inotifyFd = -1;
+        return;
+    }
+    m_watching = true;
+}
+
+FileWatcher::~FileWatcher()
+{
+    // closing the descriptor drops the watch with it
+    if (m_inotifyFd >= 0)
+        close(m_inotifyFd);
+}
+
+void FileWatcher::poll(std::vector<std::string>& changedFiles)
+{
+    if (!m_watching)
+        return;
+
+    alignas(inotify_event) char buffer[4096];
+    for (;;) {
+        const ssize_t length = read(m_inotifyFd, buffer, sizeof(buffer));
+        if (length <= 0)
+            break; // EAGAIN, nothing (more) pending
+
+        for (ssize_t offset = 0; offset < length;) {
+            const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+            if (event->len > 0) {
+                std::string name(event->name);
+                if (std::find(changedFiles.begin(), changedFiles.end(), name) == changedFiles.end())
+                    changedFiles.push_back(std::move(name));
+            }
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+        }
+    }
+}
+
+#else
+
+FileWatcher::FileWatcher(const std::string& directory) : m_directory(directory)
+{
+    std::error_code error;
+    if (!std::filesystem::is_directory(directory, error)) {
+        LOG_ERROR(Core, "FileWatcher: " << directory << " is not a directory");
+        return;
+    }
+    scan(nullptr);
+    m_watching = true;
+}
+
+FileWatcher::~FileWatcher() = default;
+
+void FileWatcher::poll(std::vector<std::string>& changedFiles)
+{
+    if (!m_watching)
+        return;
+
+    const auto now = std::chrono::steady_clock::now();
+    if (now - m_lastScan < kScanInterval)
+        return;
+    scan(&changedFiles);
+}
+
+void FileWatcher::scan(std::vector<std::string>* changedFiles)
+{
+    m_lastScan = std::chrono::steady_clock::now();
+
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(m_directory, error)) {
+        if (!entry.is_regular_file(error))
+            continue;
+        const std::string name = entry.path().filename().string();
+        const auto writeTime = entry.last_write_time(error);
+        if (error)
+            continue;
+
+        auto it = m_writeTimes.find(name);
+        if (it == m_writeTimes.end() || it->second != writeTime) {
+            // the first scan only records the baseline
+            if (changedFiles && it != m_writeTimes.end())
+                changedFiles->push_back(name);
+            m_writeTimes[name] = writeTime;
+        }
+    }
+}
+
+#endif
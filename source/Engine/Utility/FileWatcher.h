@@ -0,0 +1,52 @@
+//
+// Created by Shaun on 17/10/2026.
+//
+
+#ifndef FILEWATCHER_H
+#define FILEWATCHER_H
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Reports files that were written inside one directory (not recursive).
+ *
+ * On Linux this is an inotify watch read through a non-blocking descriptor, so poll() costs a single
+ * read() when nothing happened. Elsewhere it falls back to comparing last write times, at most once
+ * every kScanInterval. Either way poll() never blocks and is meant to be called once per frame.
+ */
+class FileWatcher
+{
+public:
+    static constexpr auto kScanInterval = std::chrono::milliseconds(250);
+
+    explicit FileWatcher(const std::string& directory);
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    [[nodiscard]] bool isWatching() const { return m_watching; }
+    [[nodiscard]] const std::string& getDirectory() const { return m_directory; }
+
+    // Appends the names (relative to the directory) of files changed since the last call
+    void poll(std::vector<std::string>& changedFiles);
+
+private:
+    std::string m_directory;
+    bool m_watching = false;
+
+#ifdef __linux__
+    int m_inotifyFd = -1;
+#else
+    void scan(std::vector<std::string>* changedFiles);
+
+    std::unordered_map<std::string, std::filesystem::file_time_type> m_writeTimes;
+    std::chrono::steady_clock::time_point m_lastScan;
+#endif
+};
+
+#endif //FILEWATCHER_H
@@ -0,0 +1,154 @@
+//
+// Created by Shaun on 17/10/2026.
+//
+
+#include "KtxFile.h"
+
+#include <algorithm>
+#include <cstring>
+#include <ostream>
+#include <GL/glew.h>
+
+#include "AtomicFile.h"
+#include "Logger.h"
+
+/*
+ * KTX 1.1 layout (https://registry.khronos.org/KTX/specs/1.0/ktxspec.v1.html):
+ *
+ * | identifier (12 bytes) | endianness | glType | glTypeSize | glFormat | glInternalFormat | glBaseInternalFormat |
+ * | pixelWidth | pixelHeight | pixelDepth | numberOfArrayElements | numberOfFaces | numberOfMipmapLevels |
+ * | bytesOfKeyValueData | key/value data |
+ * then per level: | imageSize | image bytes | padding to 4 bytes |
+ */
+namespace
+{
+    constexpr unsigned char kIdentifier[12] = {0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n'};
+    constexpr uint32_t kEndianness = 0x04030201;
+
+    struct KtxHeader
+    {
+        uint32_t endianness;
+        uint32_t glType;
+        uint32_t glTypeSize;
+        uint32_t glFormat;
+        uint32_t glInternalFormat;
+        uint32_t glBaseInternalFormat;
+        uint32_t pixelWidth;
+        uint32_t pixelHeight;
+        uint32_t pixelDepth;
+        uint32_t numberOfArrayElements;
+        uint32_t numberOfFaces;
+        uint32_t numberOfMipmapLevels;
+        uint32_t bytesOfKeyValueData;
+    };
+    static_assert(sizeof(KtxHeader) == 13 * sizeof(uint32_t), "KTX header must not be padded");
+}
+
+size_t KtxFile::getLevelSize(uint32_t internalFormat, int width, int height)
+{
+    size_t blockBytes = 0;
+    switch (internalFormat) {
+        case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_RED_RGTC1:
+            blockBytes = 8;
+            break;
+        case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+        case GL_COMPRESSED_RG_RGTC2:
+            blockBytes = 16;
+            break;
+        default:
+            return 0;
+    }
+    return ((static_cast<size_t>(width) + 3) / 4) * ((static_cast<size_t>(height) + 3) / 4) * blockBytes;
+}
+
+size_t KtxFile::getDataSize() const
+{
+    size_t size = 0;
+    for (const Level& level : m_levels)
+        size += level.size;
+    return size;
+}
+
+bool KtxFile::open(const std::string& filePath)
+{
+    m_levels.clear();
+    if (!m_file.open(filePath))
+        return false;
+
+    const unsigned char* data = m_file.data();
+    const size_t size = m_file.size();
+    KtxHeader header{};
+    if (size < sizeof(kIdentifier) + sizeof(header) || std::memcmp(data, kIdentifier, sizeof(kIdentifier)) != 0) {
+        LOG_ERROR(Texture, "KtxFile: " << filePath << " is not a KTX 1.1 file");
+        return false;
+    }
+    std::memcpy(&header, data + sizeof(kIdentifier), sizeof(header));
+
+    // only what the baker writes: little endian, compressed, 2D, one face, no array
+    if (header.endianness != kEndianness || header.glType != 0 || header.pixelDepth != 0 ||
+        header.numberOfArrayElements != 0 || header.numberOfFaces != 1 || header.numberOfMipmapLevels == 0 ||
+        getLevelSize(header.glInternalFormat, 1, 1) == 0) {
+        LOG_ERROR(Texture, "KtxFile: " << filePath << " uses an unsupported layout or format");
+        return false;
+    }
+
+    size_t offset = sizeof(kIdentifier) + sizeof(header);
+    if (header.bytesOfKeyValueData > size - offset)
+        return false;
+    offset += header.bytesOfKeyValueData;
+
+    int width = static_cast<int>(header.pixelWidth);
+    int height = static_cast<int>(header.pixelHeight);
+    for (uint32_t level = 0; level < header.numberOfMipmapLevels; level++) {
+        uint32_t imageSize = 0;
+        if (sizeof(imageSize) > size - offset)
+            break;
+        std::memcpy(&imageSize, data + offset, sizeof(imageSize));
+        offset += sizeof(imageSize);
+
+        if (imageSize != getLevelSize(header.glInternalFormat, width, height) || imageSize > size - offset)
+            break;
+        m_levels.push_back({width, height, data + offset, imageSize});
+        offset += (imageSize + 3) & ~size_t(3);
+
+        width = std::max(width / 2, 1);
+        height = std::max(height / 2, 1);
+    }
+
+    if (m_levels.size() != header.numberOfMipmapLevels) {
+        LOG_ERROR(Texture, "KtxFile: " << filePath << " is truncated or has mismatched level sizes");
+        m_levels.clear();
+        return false;
+    }
+    m_internalFormat = header.glInternalFormat;
+    return true;
+}
+
+bool KtxFile::write(const std::string& filePath, uint32_t internalFormat, uint32_t baseInternalFormat, int width,
+                    int height, const std::vector<std::vector<unsigned char>>& levels)
+{
+    KtxHeader header{};
+    header.endianness = kEndianness;
+    header.glTypeSize = 1;
+    header.glInternalFormat = internalFormat;
+    header.glBaseInternalFormat = baseInternalFormat;
+    header.pixelWidth = static_cast<uint32_t>(width);
+    header.pixelHeight = static_cast<uint32_t>(height);
+    header.numberOfFaces = 1;
+    header.numberOfMipmapLevels = static_cast<uint32_t>(levels.size());
+
+    return writeFileAtomically(filePath, LogCategory::Texture, [&](std::ostream& stream) {
+        stream.write(reinterpret_cast<const char*>(kIdentifier), sizeof(kIdentifier));
+        stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        const char padding[3] = {0, 0, 0};
+        for (const auto& level : levels) {
+            const auto imageSize = static_cast<uint32_t>(level.size());
+            stream.write(reinterpret_cast<const char*>(&imageSize), sizeof(imageSize));
+            stream.write(reinterpret_cast<const char*>(level.data()), static_cast<std::streamsize>(level.size()));
+            stream.write(padding, static_cast<std::streamsize>(((imageSize + 3) & ~3u) - imageSize));
+        }
+    });
+}
@@ -0,0 +1,64 @@
+//
+// Created by Shaun on 17/10/2026.
+//
+
+#ifndef KTXFILE_H
+#define KTXFILE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "MappedFile.h"
+
+/**
+ * @brief Reader/writer for the subset of KTX 1.1 the texture baker produces.
+ *
+ * One 2D, single face, non-array image of a block compressed format with its mip chain. KTX 1 stores
+ * GL enums directly, so the levels can go to glCompressedTexImage2D as they are. open() maps the file
+ * and validates every level size against the format, the level pointers stay valid until the object
+ * is destroyed.
+ */
+class KtxFile
+{
+public:
+    struct Level
+    {
+        int width = 0;
+        int height = 0;
+        const unsigned char* data = nullptr;
+        size_t size = 0;
+    };
+
+    KtxFile() = default;
+    KtxFile(const KtxFile&) = delete;
+    KtxFile& operator=(const KtxFile&) = delete;
+
+    bool open(const std::string& filePath);
+
+    [[nodiscard]] uint32_t getInternalFormat() const { return m_internalFormat; }
+    [[nodiscard]] int getWidth() const { return m_levels.empty() ? 0 : m_levels[0].width; }
+    [[nodiscard]] int getHeight() const { return m_levels.empty() ? 0 : m_levels[0].height; }
+    [[nodiscard]] const std::vector<Level>& getLevels() const { return m_levels; }
+    // every level together, what the texture will occupy on the GPU
+    [[nodiscard]] size_t getDataSize() const;
+
+    // levels[0] is the full size image, each following level halves it (down to 1x1)
+    static bool write(const std::string& filePath, uint32_t internalFormat, uint32_t baseInternalFormat, int width,
+                      int height, const std::vector<std::vector<unsigned char>>& levels);
+
+    static bool isKtxPath(const std::string& filePath)
+    {
+        return filePath.size() > 4 && filePath.compare(filePath.size() - 4, 4, ".ktx") == 0;
+    }
+
+    // Bytes of one level for the compressed formats open() accepts, 0 for anything else
+    static size_t getLevelSize(uint32_t internalFormat, int width, int height);
+
+private:
+    MappedFile m_file;
+    uint32_t m_internalFormat = 0;
+    std::vector<Level> m_levels;
+};
+
+#endif //KTXFILE_H
@@ -0,0 +1,200 @@
+//
+// Created by Shaun on 17/10/2026.
+//
+
+#include "Logger.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+namespace
+{
+    static_assert((Logger::kCapacity & (Logger::kCapacity - 1)) == 0, "Logger capacity must be a power of two");
+
+    // Trace stays opt-in even when it is compiled in, it is meant for per-frame spam
+    constexpr LogLevel kDefaultLevel = isLogLevelCompiledIn(static_cast<int>(LogLevel::Debug))
+                                           ? LogLevel::Debug
+                                           : static_cast<LogLevel>(ENGINE_LOG_COMPILED_LEVEL);
+
+    constexpr auto kFlushInterval = std::chrono::milliseconds(5);
+}
+
+Logger& Logger::getInstance()
+{
+    static Logger instance;
+    return instance;
+}
+
+Logger::Logger() : m_slots(new Slot[kCapacity])
+{
+    for (size_t i = 0; i < kCapacity; ++i)
+        m_slots[i].sequence.store(i, std::memory_order_relaxed);
+    for (auto& level : m_levels)
+        level.store(kDefaultLevel, std::memory_order_relaxed);
+
+    m_thread = std::thread(&Logger::flushLoop, this);
+}
+
+Logger::~Logger()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_flushMutex);
+        m_stopping.store(true, std::memory_order_release);
+    }
+    m_flushCondition.notify_all();
+    if (m_thread.joinable())
+        m_thread.join();
+}
+
+void Logger::setLevel(LogCategory category, LogLevel level)
+{
+    m_levels[static_cast<size_t>(category)].store(level, std::memory_order_relaxed);
+}
+
+void Logger::setLevel(LogLevel level)
+{
+    for (auto& categoryLevel : m_levels)
+        categoryLevel.store(level, std::memory_order_relaxed);
+}
+
+LogLevel Logger::getLevel(LogCategory category) const
+{
+    return m_levels[static_cast<size_t>(category)].load(std::memory_order_relaxed);
+}
+
+void Logger::write(LogCategory category, LogLevel level, const std::string& message)
+{
+    // claim a slot: it is free for position pos once its sequence has come round to pos
+    size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+    Slot* slot = nullptr;
+    for (;;) {
+        slot = &m_slots[pos & (kCapacity - 1)];
+        const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        const auto difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+        if (difference == 0) {
+            if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        } else if (difference < 0) {
+            // the flush thread hasn't caught up with this lap yet, drop instead of waiting
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        } else {
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->category = category;
+    slot->level = level;
+    if (message.size() <= kMaxMessageLength) {
+        std::memcpy(slot->text, message.data(), message.size());
+        slot->length = static_cast<uint16_t>(message.size());
+    } else {
+        std::memcpy(slot->text, message.data(), kMaxMessageLength - 3);
+        std::memcpy(slot->text + kMaxMessageLength - 3, "...", 3);
+        slot->length = static_cast<uint16_t>(kMaxMessageLength);
+    }
+    slot->sequence.store(pos + 1, std::memory_order_release);
+}
+
+void Logger::flush()
+{
+    const size_t target = m_enqueuePos.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(m_flushMutex);
+    m_flushCondition.notify_all();
+    m_flushCondition.wait(lock, [&]() {
+        return m_written.load(std::memory_order_acquire) >= target || m_stopping.load(std::memory_order_acquire);
+    });
+}
+
+std::ostringstream& Logger::beginMessage()
+{
+    thread_local std::ostringstream stream;
+    stream.str(std::string());
+    stream.clear();
+    return stream;
+}
+
+const char* Logger::getLevelName(LogLevel level)
+{
+    switch (level) {
+        case LogLevel::Trace: return "Trace";
+        case LogLevel::Debug: return "Debug";
+        case LogLevel::Info: return "Info";
+        case LogLevel::Warning: return "Warning";
+        case LogLevel::Error: return "Error";
+        case LogLevel::Off: break;
+    }
+    return "Off";
+}
+
+const char* Logger::getCategoryName(LogCategory category)
+{
+    switch (category) {
+        case LogCategory::Core: return "Core";
+        case LogCategory::Renderer: return "Renderer";
+        case LogCategory::Shader: return "Shader";
+        case LogCategory::Texture: return "Texture";
+        case LogCategory::Mesh: return "Mesh";
+        case LogCategory::Import: return "Import";
+        case LogCategory::Scene: return "Scene";
+        case LogCategory::Count: break;
+    }
+    return "Unknown";
+}
+
+bool Logger::tryPop(Slot*& slot)
+{
+    Slot& candidate = m_slots[m_dequeuePos & (kCapacity - 1)];
+    if (candidate.sequence.load(std::memory_order_acquire) != m_dequeuePos + 1)
+        return false;
+    slot = &candidate;
+    return true;
+}
+
+void Logger::release(Slot& slot)
+{
+    // hand the slot back to producers for the next lap round the ring
+    slot.sequence.store(m_dequeuePos + kCapacity, std::memory_order_release);
+    ++m_dequeuePos;
+}
+
+size_t Logger::drain()
+{
+    size_t count = 0;
+    Slot* slot = nullptr;
+    while (tryPop(slot)) {
+        std::ostream& out = slot->level >= LogLevel::Warning ? std::cerr : std::cout;
+        out << '[' << getLevelName(slot->level) << "][" << getCategoryName(slot->category) << "] ";
+        out.write(slot->text, slot->length);
+        out << '\n';
+        release(*slot);
+        ++count;
+    }
+
+    const size_t dropped = m_dropped.exchange(0, std::memory_order_relaxed);
+    if (dropped > 0)
+        std::cerr << "[Warning][Core] " << dropped << " log messages dropped, ring buffer was full\n";
+
+    if (count > 0 || dropped > 0) {
+        std::cout.flush();
+        std::cerr.flush();
+        m_written.fetch_add(count, std::memory_order_release);
+    }
+    return count;
+}
+
+void Logger::flushLoop()
+{
+    for (;;) {
+        const bool stopping = m_stopping.load(std::memory_order_acquire);
+        // the final drain after stopping picks up anything logged right up to shutdown
+        drain();
+
+        std::unique_lock<std::mutex> lock(m_flushMutex);
+        m_flushCondition.notify_all();
+        if (stopping)
+            break;
+        m_flushCondition.wait_for(lock, kFlushInterval);
+    }
+}
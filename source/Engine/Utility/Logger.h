@@ -0,0 +1,152 @@
+//
+// Created by Shaun on 17/10/2026.
+//
+
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+enum class LogLevel : uint8_t
+{
+    Trace,
+    Debug,
+    Info,
+    Warning,
+    Error,
+    Off
+};
+
+enum class LogCategory : uint8_t
+{
+    Core,
+    Renderer,
+    Shader,
+    Texture,
+    Mesh,
+    Import,
+    Scene,
+    Count
+};
+
+// Anything below this level is removed at compile time. Release builds keep Info and up;
+// define ENGINE_LOG_COMPILED_LEVEL to override (0 = Trace ... 5 = Off).
+#ifndef ENGINE_LOG_COMPILED_LEVEL
+#ifdef NDEBUG
+#define ENGINE_LOG_COMPILED_LEVEL 2
+#else
+#define ENGINE_LOG_COMPILED_LEVEL 0
+#endif
+#endif
+
+// Takes the level as a plain int: comparing the uint8_t enum against a compiled level of 0 directly
+// is always true and trips -Wtype-limits in every file that logs
+constexpr bool isLogLevelCompiledIn(int level)
+{
+    return level >= ENGINE_LOG_COMPILED_LEVEL;
+}
+
+/**
+ * @brief Engine-wide asynchronous logger.
+ *
+ * Producers format their message on the calling thread and claim a slot in a fixed-size
+ * lock-free ring (bounded MPMC queue with per-slot sequence numbers). They never take a lock
+ * or touch a stream, so logging from the frame loop can't stall on terminal I/O. A background
+ * thread drains the ring and writes to stdout (stderr for warnings and errors). When the ring
+ * is full the message is dropped and counted rather than blocking the producer.
+ *
+ * Use the LOG_* macros rather than calling write() directly: they skip formatting entirely when
+ * the category's level filters the message out, and compile the call away when the level is
+ * below ENGINE_LOG_COMPILED_LEVEL.
+ */
+class Logger
+{
+public:
+    static constexpr size_t kCapacity = 1024;         // must be a power of two
+    static constexpr size_t kMaxMessageLength = 480;  // longer messages are truncated
+
+    static Logger& getInstance();
+
+    ~Logger();
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    void setLevel(LogCategory category, LogLevel level);
+    void setLevel(LogLevel level); // every category
+    [[nodiscard]] LogLevel getLevel(LogCategory category) const;
+
+    [[nodiscard]] bool isEnabled(LogCategory category, LogLevel level) const
+    {
+        return level >= m_levels[static_cast<size_t>(category)].load(std::memory_order_relaxed);
+    }
+
+    void write(LogCategory category, LogLevel level, const std::string& message);
+
+    // Blocks until everything logged before the call has been written out
+    void flush();
+
+    // Per-thread scratch stream the macros format into, so enabled log sites don't allocate a new one each time
+    static std::ostringstream& beginMessage();
+
+    static const char* getLevelName(LogLevel level);
+    static const char* getCategoryName(LogCategory category);
+
+private:
+    Logger();
+
+    struct Slot
+    {
+        std::atomic<size_t> sequence{0};
+        LogCategory category = LogCategory::Core;
+        LogLevel level = LogLevel::Info;
+        uint16_t length = 0;
+        char text[kMaxMessageLength];
+    };
+
+    bool tryPop(Slot*& slot);
+    void release(Slot& slot);
+    size_t drain();
+    void flushLoop();
+
+    std::unique_ptr<Slot[]> m_slots;
+    alignas(64) std::atomic<size_t> m_enqueuePos{0};
+    alignas(64) size_t m_dequeuePos = 0; // flush thread only
+    std::atomic<size_t> m_written{0};
+    std::atomic<size_t> m_dropped{0};
+
+    std::array<std::atomic<LogLevel>, static_cast<size_t>(LogCategory::Count)> m_levels;
+
+    std::mutex m_flushMutex;
+    std::condition_variable m_flushCondition;
+    std::atomic<bool> m_stopping{false};
+    std::thread m_thread;
+};
+
+#define ENGINE_LOG(level, category, message)                                                          \
+    do {                                                                                              \
+        if constexpr (isLogLevelCompiledIn(static_cast<int>(level))) {                                \
+            Logger& engineLogger_ = Logger::getInstance();                                            \
+            if (engineLogger_.isEnabled(category, level)) {                                           \
+                std::ostringstream& engineLogStream_ = Logger::beginMessage();                        \
+                engineLogStream_ << message;                                                          \
+                engineLogger_.write(category, level, engineLogStream_.str());                         \
+            }                                                                                         \
+        }                                                                                             \
+    } while (false)
+
+#define LOG_TRACE(category, message) ENGINE_LOG(LogLevel::Trace, LogCategory::category, message)
+#define LOG_DEBUG(category, message) ENGINE_LOG(LogLevel::Debug, LogCategory::category, message)
+#define LOG_INFO(category, message) ENGINE_LOG(LogLevel::Info, LogCategory::category, message)
+#define LOG_WARNING(category, message) ENGINE_LOG(LogLevel::Warning, LogCategory::category, message)
+#define LOG_ERROR(category, message) ENGINE_LOG(LogLevel::Error, LogCategory::category, message)
+
+#endif //LOGGER_H
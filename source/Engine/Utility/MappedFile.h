@@ -0,0 +1,44 @@
+//
+// Created by Shaun on 17/10/2026.
+//
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief Read-only memory mapping of a whole file.
+ *
+ * Used by the importers to read large binary/text files without copying them through iostreams.
+ * The mapping is released when the object is destroyed or close() is called.
+ */
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& filepath) { open(filepath); }
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& filepath);
+    void close();
+
+    [[nodiscard]] bool isOpen() const { return m_data != nullptr; }
+    [[nodiscard]] const unsigned char* data() const { return m_data; }
+    [[nodiscard]] size_t size() const { return m_size; }
+
+private:
+    const unsigned char* m_data = nullptr;
+    size_t m_size = 0;
+
+#ifdef _WIN32
+    void* m_fileHandle = nullptr;
+    void* m_mappingHandle = nullptr;
+#endif
+};
+
+#endif //MAPPEDFILE_H
@@ -0,0 +1,300 @@
+//
+// Created by Shaun on 17/10/2026.
+//
+
+#include "Profiler.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <imgui.h>
+
+namespace
+{
+    constexpr size_t kNoScope = static_cast<size_t>(-1);
+
+    const ImU32 kPassColours[] = {
+        IM_COL32(86, 156, 214, 255), IM_COL32(220, 120, 70, 255), IM_COL32(110, 190, 110, 255),
+        IM_COL32(200, 90, 160, 255), IM_COL32(230, 200, 80, 255), IM_COL32(120, 200, 200, 255),
+        IM_COL32(160, 130, 220, 255), IM_COL32(180, 180, 180, 255)
+    };
+
+    ImU32 colourFor(size_t index) { return kPassColours[index % (sizeof(kPassColours) / sizeof(kPassColours[0]))]; }
+
+    double millisecondsSince(std::chrono::high_resolution_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+}
+
+Profiler& Profiler::getInstance()
+{
+    static Profiler instance;
+    return instance;
+}
+
+Profiler::~Profiler()
+{
+    // the GL context is usually gone by the time statics are destroyed, so query names are simply leaked
+}
+
+Profiler::PassHistory& Profiler::historyFor(const char* name)
+{
+    for (auto& pass : m_passes) {
+        if (pass.name == name)
+            return pass;
+    }
+    m_passes.push_back(PassHistory{name, {}, {}});
+    return m_passes.back();
+}
+
+void Profiler::beginFrame()
+{
+    PendingFrame& frame = m_pending[m_frameIndex % kQueryLatency];
+    if (frame.inFlight)
+        collect(frame);
+
+    frame.scopes.clear();
+    frame.frameIndex = m_frameIndex;
+    frame.inFlight = true;
+
+    m_counters.clear();
+    m_openScopes.clear();
+    m_gpuQueryOpen = false;
+    m_frameActive = true;
+    m_frameStart = std::chrono::high_resolution_clock::now();
+}
+
+void Profiler::endFrame()
+{
+    if (!m_frameActive)
+        return;
+    while (!m_openScopes.empty())
+        endScope();
+
+    PendingFrame& frame = m_pending[m_frameIndex % kQueryLatency];
+    // the frame total rides along as a pseudo scope so it lines up with the GPU results when collected
+    frame.scopes.push_back({nullptr, -1, 0.0, millisecondsSince(m_frameStart), 0});
+
+    m_frameActive = false;
+    m_frameIndex++;
+}
+
+void Profiler::beginScope(const char* name)
+{
+    if (!m_frameActive)
+        return;
+
+    PendingFrame& frame = m_pending[m_frameIndex % kQueryLatency];
+    if (frame.scopes.size() >= kMaxScopes) {
+        m_openScopes.push_back(kNoScope);
+        return;
+    }
+
+    ScopeRecord record{name, static_cast<int>(m_openScopes.size()), millisecondsSince(m_frameStart), 0.0, 0};
+    if (record.depth == 0 && !m_gpuQueryOpen) {
+        if (m_freeQueries.empty()) {
+            GLuint query = 0;
+            glGenQueries(1, &query);
+            m_freeQueries.push_back(query);
+        }
+        record.query = m_freeQueries.back();
+        m_freeQueries.pop_back();
+        glBeginQuery(GL_TIME_ELAPSED, record.query);
+        m_gpuQueryOpen = true;
+    }
+
+    m_openScopes.push_back(frame.scopes.size());
+    frame.scopes.push_back(record);
+}
+
+void Profiler::endScope()
+{
+    if (!m_frameActive || m_openScopes.empty())
+        return;
+
+    size_t index = m_openScopes.back();
+    m_openScopes.pop_back();
+    if (index == kNoScope)
+        return;
+
+    ScopeRecord& record = m_pending[m_frameIndex % kQueryLatency].scopes[index];
+    record.cpuMs = millisecondsSince(m_frameStart) - record.cpuStartMs;
+    if (record.query) {
+        glEndQuery(GL_TIME_ELAPSED);
+        m_gpuQueryOpen = false;
+    }
+}
+
+void Profiler::setCounter(const char* name, double value)
+{
+    for (auto& counter : m_counters) {
+        if (counter.name == name) {
+            counter.value = value;
+            return;
+        }
+    }
+    m_counters.push_back({name, value});
+}
+
+/*
+ * Called kQueryLatency frames after the frame was recorded. Results that still aren't available are
+ * dropped (shown as 0) rather than waited on.
+ */
+void Profiler::collect(PendingFrame& frame)
+{
+    const size_t slot = frame.frameIndex % kHistoryFrames;
+    for (auto& pass : m_passes) {
+        pass.cpuMs[slot] = 0.0f;
+        pass.gpuMs[slot] = 0.0f;
+    }
+
+    m_lastTimeline.clear();
+    for (const auto& scope : frame.scopes) {
+        if (!scope.name) {
+            m_frameCpuMs[slot] = static_cast<float>(scope.cpuMs);
+            m_lastFrameCpuMs = scope.cpuMs;
+            continue;
+        }
+        m_lastTimeline.push_back(scope);
+        if (scope.depth != 0)
+            continue;
+
+        PassHistory& pass = historyFor(scope.name);
+        pass.cpuMs[slot] += static_cast<float>(scope.cpuMs);
+        if (scope.query) {
+            GLint available = 0;
+            glGetQueryObjectiv(scope.query, GL_QUERY_RESULT_AVAILABLE, &available);
+            if (available) {
+                GLuint64 elapsedNs = 0;
+                glGetQueryObjectui64v(scope.query, GL_QUERY_RESULT, &elapsedNs);
+                pass.gpuMs[slot] += static_cast<float>(static_cast<double>(elapsedNs) / 1.0e6);
+            }
+            m_freeQueries.push_back(scope.query);
+        }
+    }
+    frame.inFlight = false;
+    // frames are collected in order, so this one is now the newest in the history
+    m_collectedFrames = frame.frameIndex + 1;
+}
+
+void Profiler::drawImGui()
+{
+    ImGui::Checkbox("GPU times", &m_showGpu);
+
+    const uint64_t completedFrames = m_collectedFrames;
+    const size_t historyCount = static_cast<size_t>(std::min<uint64_t>(completedFrames, kHistoryFrames));
+    if (historyCount == 0) {
+        ImGui::Text("Waiting for results...");
+        return;
+    }
+    const uint64_t newestFrame = completedFrames - 1;
+
+    // Rolling stacked graph, one column per frame, one colour per pass
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+    const ImVec2 origin = ImGui::GetCursorScreenPos();
+    const float width = std::max(ImGui::GetContentRegionAvail().x, 100.0f);
+    const float height = 120.0f;
+    const float columnWidth = width / static_cast<float>(kHistoryFrames);
+
+    float maxTotal = m_frameBudgetMs * 1.5f;
+    for (size_t i = 0; i < historyCount; i++) {
+        size_t slot = (newestFrame - i) % kHistoryFrames;
+        float total = 0.0f;
+        for (const auto& pass : m_passes)
+            total += m_showGpu ? pass.gpuMs[slot] : pass.cpuMs[slot];
+        maxTotal = std::max(maxTotal, total);
+    }
+    const float scale = height / maxTotal;
+
+    drawList->AddRectFilled(origin, ImVec2(origin.x + width, origin.y + height), IM_COL32(25, 25, 25, 255));
+    for (size_t i = 0; i < historyCount; i++) {
+        size_t slot = (newestFrame - i) % kHistoryFrames;
+        float x1 = origin.x + width - static_cast<float>(i) * columnWidth;
+        float x0 = x1 - columnWidth;
+        float y = origin.y + height;
+        for (size_t p = 0; p < m_passes.size(); p++) {
+            float value = m_showGpu ? m_passes[p].gpuMs[slot] : m_passes[p].cpuMs[slot];
+            if (value <= 0.0f)
+                continue;
+            float top = y - value * scale;
+            drawList->AddRectFilled(ImVec2(x0, top), ImVec2(x1, y), colourFor(p));
+            y = top;
+        }
+    }
+    float budgetY = origin.y + height - m_frameBudgetMs * scale;
+    drawList->AddLine(ImVec2(origin.x, budgetY), ImVec2(origin.x + width, budgetY), IM_COL32(255, 60, 60, 255));
+    ImGui::Dummy(ImVec2(width, height));
+
+    // Per-pass averages over the history window, flagging anything that alone exceeds the budget
+    if (ImGui::BeginTable("ProfilerPasses", 4)) {
+        ImGui::TableSetupColumn("Pass");
+        ImGui::TableSetupColumn("CPU ms (avg / last)");
+        ImGui::TableSetupColumn("GPU ms (avg / last)");
+        ImGui::TableSetupColumn("");
+        ImGui::TableHeadersRow();
+
+        const size_t newestSlot = newestFrame % kHistoryFrames;
+        for (size_t p = 0; p < m_passes.size(); p++) {
+            const PassHistory& pass = m_passes[p];
+            float cpuTotal = 0.0f, gpuTotal = 0.0f;
+            for (size_t i = 0; i < historyCount; i++) {
+                size_t slot = (newestFrame - i) % kHistoryFrames;
+                cpuTotal += pass.cpuMs[slot];
+                gpuTotal += pass.gpuMs[slot];
+            }
+            float lastWorst = std::max(pass.cpuMs[newestSlot], pass.gpuMs[newestSlot]);
+
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImDrawList* rowList = ImGui::GetWindowDrawList();
+            ImVec2 swatch = ImGui::GetCursorScreenPos();
+            float lineHeight = ImGui::GetTextLineHeight();
+            rowList->AddRectFilled(swatch, ImVec2(swatch.x + lineHeight, swatch.y + lineHeight), colourFor(p));
+            ImGui::Dummy(ImVec2(lineHeight, lineHeight));
+            ImGui::SameLine();
+            ImGui::TextUnformatted(pass.name.c_str());
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f / %.3f", cpuTotal / static_cast<float>(historyCount), pass.cpuMs[newestSlot]);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f / %.3f", gpuTotal / static_cast<float>(historyCount), pass.gpuMs[newestSlot]);
+            ImGui::TableNextColumn();
+            if (lastWorst > m_frameBudgetMs)
+                ImGui::TextUnformatted("OVER BUDGET");
+        }
+        ImGui::EndTable();
+    }
+
+    // CPU timeline of the newest collected frame, nested scopes stacked underneath their parents
+    ImGui::Text("Frame CPU: %.3f ms (budget %.2f ms)", m_lastFrameCpuMs, m_frameBudgetMs);
+    if (m_lastFrameCpuMs > 0.0) {
+        const ImVec2 timelineOrigin = ImGui::GetCursorScreenPos();
+        const float rowHeight = ImGui::GetTextLineHeightWithSpacing();
+        int maxDepth = 0;
+        for (const auto& scope : m_lastTimeline)
+            maxDepth = std::max(maxDepth, scope.depth);
+
+        const float msToPixels = width / static_cast<float>(std::max(m_lastFrameCpuMs, static_cast<double>(m_frameBudgetMs)));
+        for (const auto& scope : m_lastTimeline) {
+            size_t colourIndex = 0;
+            for (size_t p = 0; p < m_passes.size(); p++) {
+                if (m_passes[p].name == scope.name)
+                    colourIndex = p;
+            }
+            ImVec2 min(timelineOrigin.x + static_cast<float>(scope.cpuStartMs) * msToPixels,
+                       timelineOrigin.y + static_cast<float>(scope.depth) * rowHeight);
+            ImVec2 max(min.x + std::max(static_cast<float>(scope.cpuMs) * msToPixels, 1.0f), min.y + rowHeight - 1.0f);
+            drawList->AddRectFilled(min, max, colourFor(colourIndex));
+
+            char label[96];
+            std::snprintf(label, sizeof(label), "%s %.2f", scope.name, scope.cpuMs);
+            drawList->PushClipRect(min, max, true);
+            drawList->AddText(ImVec2(min.x + 2.0f, min.y), IM_COL32(0, 0, 0, 255), label);
+            drawList->PopClipRect();
+        }
+        ImGui::Dummy(ImVec2(width, static_cast<float>(maxDepth + 1) * rowHeight));
+    }
+
+    for (const auto& counter : m_counters)
+        ImGui::Text("%s: %.0f", counter.name.c_str(), counter.value);
+}
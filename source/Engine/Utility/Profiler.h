@@ -0,0 +1,115 @@
+//
+// Created by Shaun on 17/10/2026.
+//
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <array>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <GL/glew.h>
+
+/**
+ * @brief Per-pass CPU/GPU frame profiler.
+ *
+ * Scopes record a CPU time with a high resolution clock and, for top level scopes, a GPU time with a
+ * GL_TIME_ELAPSED query. Query sets are kept in a ring of kQueryLatency frames and a frame's results are
+ * only collected when its set comes round again, skipping any that still aren't available, so reading
+ * them never stalls. GL_TIME_ELAPSED can't nest, nested scopes only get CPU times.
+ *
+ * Nothing is recorded outside beginFrame()/endFrame(), so passes that are also timed elsewhere
+ * (e.g. the headless BenchmarkRecorder) don't end up with overlapping queries.
+ */
+class Profiler
+{
+public:
+    static constexpr size_t kQueryLatency = 3;   // frames between issuing a query and reading it
+    static constexpr size_t kHistoryFrames = 240;
+    static constexpr size_t kMaxScopes = 32;     // per frame
+
+    static Profiler& getInstance();
+
+    void beginFrame();
+    void endFrame();
+
+    void beginScope(const char* name);
+    void endScope();
+
+    // Per-frame counters shown next to the graph (draw calls, triangles, state changes)
+    void setCounter(const char* name, double value);
+
+    void setFrameBudgetMs(float budgetMs) { m_frameBudgetMs = budgetMs; }
+
+    // Rolling per-pass graph, the latest frame's timeline and the counters. Call between ImGui::Begin/End.
+    void drawImGui();
+
+private:
+    Profiler() = default;
+    ~Profiler();
+
+    struct ScopeRecord
+    {
+        const char* name;
+        int depth;
+        double cpuStartMs;     // relative to the frame start
+        double cpuMs;
+        GLuint query;          // 0 for nested scopes
+    };
+
+    struct PendingFrame
+    {
+        uint64_t frameIndex = 0;
+        std::vector<ScopeRecord> scopes;
+        bool inFlight = false;
+    };
+
+    struct PassHistory
+    {
+        std::string name;
+        std::array<float, kHistoryFrames> cpuMs{};
+        std::array<float, kHistoryFrames> gpuMs{};
+    };
+
+    struct Counter
+    {
+        std::string name;
+        double value;
+    };
+
+    PassHistory& historyFor(const char* name);
+    void collect(PendingFrame& frame);
+
+    std::array<PendingFrame, kQueryLatency> m_pending;
+    std::vector<GLuint> m_freeQueries;
+    std::vector<size_t> m_openScopes;           // indices into the current frame's scopes
+    bool m_frameActive = false;
+    bool m_gpuQueryOpen = false;
+    uint64_t m_frameIndex = 0;
+    uint64_t m_collectedFrames = 0;             // the newest collected frame is m_collectedFrames - 1
+    std::chrono::high_resolution_clock::time_point m_frameStart;
+
+    std::vector<PassHistory> m_passes;           // top level scopes only
+    std::array<float, kHistoryFrames> m_frameCpuMs{};
+    std::vector<ScopeRecord> m_lastTimeline;     // CPU timeline of the newest completed frame
+    double m_lastFrameCpuMs = 0.0;
+    std::vector<Counter> m_counters;
+    float m_frameBudgetMs = 1000.0f / 60.0f;
+    bool m_showGpu = true;
+};
+
+/**
+ * @brief RAII profiler scope, ProfileScope scope("Shadow pass");
+ */
+class ProfileScope
+{
+public:
+    explicit ProfileScope(const char* name) { Profiler::getInstance().beginScope(name); }
+    ~ProfileScope() { Profiler::getInstance().endScope(); }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+};
+
+#endif //PROFILER_H
@@ -0,0 +1,100 @@
+//
+// Created by Shaun on 17/10/2026.
+//
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Small fixed-size worker pool shared by the engine's CPU-side jobs (import, decode, etc).
+ *
+ * enqueue() is fire-and-forget. parallelFor() splits [0, count) into batches, lets the calling
+ * thread help out, and only returns once every index has been processed. Don't call parallelFor()
+ * from inside a pool job - the waiting worker can starve the helpers it is waiting on.
+ */
+class ThreadPool
+{
+public:
+    static ThreadPool& getInstance();
+
+    explicit ThreadPool(size_t threadCount);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void enqueue(std::function<void()> job);
+
+    // Calls func(i) for every i in [0, count). Blocks until all calls have returned.
+    template <typename Func>
+    void parallelFor(size_t count, Func&& func, size_t batchSize = 1);
+
+    [[nodiscard]] size_t getThreadCount() const { return m_workers.size(); }
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread> m_workers;
+    std::deque<std::function<void()>> m_jobs;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_stopping = false;
+};
+
+template <typename Func>
+void ThreadPool::parallelFor(size_t count, Func&& func, size_t batchSize)
+{
+    if (count == 0)
+        return;
+    if (batchSize == 0)
+        batchSize = 1;
+
+    const size_t batchCount = (count + batchSize - 1) / batchSize;
+    if (batchCount == 1 || m_workers.empty()) {
+        for (size_t i = 0; i < count; ++i)
+            func(i);
+        return;
+    }
+
+    std::atomic<size_t> nextBatch{0};
+    std::mutex doneMutex;
+    std::condition_variable doneCondition;
+    size_t runningHelpers = 0;
+
+    auto runBatches = [&]() {
+        for (size_t batch = nextBatch.fetch_add(1); batch < batchCount; batch = nextBatch.fetch_add(1)) {
+            const size_t begin = batch * batchSize;
+            const size_t end = begin + batchSize < count ? begin + batchSize : count;
+            for (size_t i = begin; i < end; ++i)
+                func(i);
+        }
+    };
+
+    // no point waking more workers than there are batches left for them
+    const size_t helpers = batchCount - 1 < m_workers.size() ? batchCount - 1 : m_workers.size();
+    runningHelpers = helpers;
+    for (size_t i = 0; i < helpers; ++i) {
+        enqueue([&]() {
+            runBatches();
+            std::lock_guard<std::mutex> lock(doneMutex);
+            if (--runningHelpers == 0)
+                doneCondition.notify_one();
+        });
+    }
+
+    runBatches();
+
+    std::unique_lock<std::mutex> lock(doneMutex);
+    doneCondition.wait(lock, [&]() { return runningHelpers == 0; });
+}
+
+#endif //THREADPOOL_H
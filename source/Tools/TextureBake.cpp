@@ -0,0 +1,135 @@
+//
+// Created by Shaun on 17/10/2026.
+//
+
+/*
+ * TextureBake - offline texture compression for the engine.
+ *
+ * usage: TextureBake [--force] [--color | --normal | --data] <model | image | directory>...
+ *
+ *   model      every texture its materials use, baked as the slot it is bound to (base colour -> BC1/BC3,
+ *              normals -> BC5, roughness -> BC4)
+ *   image      baked as the format given by the last --color/--normal/--data, guessed from the name otherwise
+ *   directory  every image inside it, formats guessed from the names
+ *   --force    rebake even if the .ktx is newer than its source
+ *
+ * Output goes next to each source as <name>.ktx, see TextureBaker.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#include "Logger.h"
+#include "TextureBaker.h"
+#include "ThreadPool.h"
+
+namespace
+{
+    struct BakeJob
+    {
+        std::string path;
+        BlockFormat format;
+    };
+
+    bool isImageFile(const std::filesystem::path& path)
+    {
+        std::string extension = path.extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return std::tolower(c); });
+        return extension == ".png" || extension == ".jpg" || extension == ".jpeg" || extension == ".tga" ||
+               extension == ".bmp" || extension == ".psd" || extension == ".hdr";
+    }
+
+    void addJob(std::vector<BakeJob>& jobs, const std::string& path, BlockFormat format)
+    {
+        auto existing = std::find_if(jobs.begin(), jobs.end(), [&path](const BakeJob& job) { return job.path == path; });
+        if (existing == jobs.end())
+            jobs.push_back({path, format});
+    }
+
+    // Same slots and path resolution as AssimpImporter::extractMaterialData
+    bool addModelTextures(std::vector<BakeJob>& jobs, const std::string& modelPath)
+    {
+        Assimp::Importer importer;
+        const aiScene* scene = importer.ReadFile(modelPath, 0);
+        if (!scene) {
+            LOG_ERROR(Import, "TextureBake: failed to read " << modelPath << ": " << importer.GetErrorString());
+            return false;
+        }
+
+        const std::string directory = modelPath.substr(0, modelPath.find_last_of("/\\"));
+        const std::pair<aiTextureType, BlockFormat> slots[] = {
+            {aiTextureType_BASE_COLOR, BlockFormat::BC1},
+            {aiTextureType_DIFFUSE_ROUGHNESS, BlockFormat::BC4},
+            {aiTextureType_NORMALS, BlockFormat::BC5},
+        };
+        for (unsigned int m = 0; m < scene->mNumMaterials; m++) {
+            for (const auto& [type, format] : slots) {
+                aiString path;
+                if (scene->mMaterials[m]->GetTexture(type, 0, &path) != AI_SUCCESS)
+                    continue;
+                // embedded textures ("*<index>") live inside the model and can't be baked next to it
+                const std::string texturePath = path.C_Str();
+                if (!texturePath.empty() && texturePath[0] != '*')
+                    addJob(jobs, directory + "/" + texturePath, format);
+            }
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    bool force = false;
+    std::optional<BlockFormat> imageFormat;
+    std::vector<BakeJob> jobs;
+    bool inputsValid = true;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string argument = argv[i];
+        if (argument == "--force") {
+            force = true;
+        } else if (argument == "--color") {
+            imageFormat = BlockFormat::BC1;
+        } else if (argument == "--normal") {
+            imageFormat = BlockFormat::BC5;
+        } else if (argument == "--data") {
+            imageFormat = BlockFormat::BC4;
+        } else if (std::filesystem::is_directory(argument)) {
+            for (const auto& entry : std::filesystem::directory_iterator(argument)) {
+                if (entry.is_regular_file() && isImageFile(entry.path()))
+                    addJob(jobs, entry.path().string(), TextureBaker::guessFormat(entry.path().string()));
+            }
+        } else if (isImageFile(argument)) {
+            addJob(jobs, argument, imageFormat ? *imageFormat : TextureBaker::guessFormat(argument));
+        } else {
+            inputsValid &= addModelTextures(jobs, argument);
+        }
+    }
+
+    if (jobs.empty()) {
+        LOG_ERROR(Core, "usage: TextureBake [--force] [--color | --normal | --data] <model | image | directory>...");
+        Logger::getInstance().flush();
+        return 1;
+    }
+
+    // each bake is independent and CPU bound
+    std::atomic<size_t> failures{0};
+    ThreadPool::getInstance().parallelFor(jobs.size(), [&](size_t i) {
+        if (!TextureBaker::bake(jobs[i].path, jobs[i].format, force))
+            failures++;
+    });
+
+    LOG_INFO(Core, "TextureBake: " << jobs.size() - failures << " of " << jobs.size() << " textures baked or up to date");
+    Logger::getInstance().flush();
+    return failures == 0 && inputsValid ? 0 : 1;
+}
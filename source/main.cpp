@@ -3,7 +3,6 @@
 #include <imgui_impl_opengl3.h>
 
 #include <Camera.h>
-#include <iostream>
 #include <Lights/Light.h>
 #include <Renderer.h>
 #include <Shader.h>
@@ -13,50 +12,134 @@
 #include <GLFW/glfw3.h>
 
 #include "Framebuffer.h"
+#include "FrameUniforms.h"
 #include "Scene.h"
 #include "ShaderManager.h"
+#include "TextureManager.h"
 
+#include <algorithm>
 #include <chrono>
+#include <cstdio>
+#include <cstdlib>
 
 #include "Lights/DirectionalLight.h"
 #include "Lights/PointLight.h"
+#include "Importers/ModelLoader.h"
+#include "Mesh.h"
+#include "CameraPath.h"
+#include "BenchmarkRecorder.h"
+#include "Profiler.h"
+#include "Logger.h"
+#include "Components/MaterialComponent.h"
+
+// --headless: render a scripted camera path offscreen and write pass timings to JSON, no window or ImGui
+struct HeadlessOptions
+{
+    bool enabled = false;
+    bool useOSMesa = false;          // --gl-api osmesa, otherwise EGL (surfaceless where the platform allows)
+    int width = 1920, height = 1080; // --size WxH
+    int frames = 300;                // --frames N, recorded frames
+    int warmupFrames = 30;           // --warmup N, rendered first but not recorded
+    std::string cameraPathFile;      // --camera-path file, defaults to an orbit around the scene
+    std::string outputFile = "benchmark.json"; // --output file
+    bool useIndirect = true;         // --no-indirect, per-mesh draws for comparing against multi-draw-indirect
+};
+
+// Everything a frame needs, shared by the interactive loop and the headless benchmark
+struct FrameContext
+{
+    Renderer& renderer;
+    Scene& scene;
+    ShaderManager& shaderManager;
+    ShadowMap& shadowMap;
+    FrameUniforms& frameUniforms;
+    Carbon::FrameBuffer& framebuffer;
+    Camera& camera;
+    DirectionalLight& dirLight;
+    unsigned int quadVAO;
+};
+
+bool setupOpenGL(GLFWwindow*& window, const HeadlessOptions& headless);
+bool parseHeadlessOptions(int argc, char** argv, HeadlessOptions& options);
+void bindStaticSamplers(const Shader& shader);
+void preloadSceneVariants(FrameContext& frame);
+void beginSceneFrame(FrameContext& frame);
+void renderShadowPass(FrameContext& frame);
+void renderMainPass(FrameContext& frame);
+void blitFramebuffer(FrameContext& frame);
+int runHeadlessBenchmark(FrameContext& frame, const HeadlessOptions& options, double shaderStartupMs);
 
-bool setupOpenGL(GLFWwindow*& window);
 bool showDecal = true;
 bool V_SYNC = 0;
+bool ASYNC_TEXTURES = true;
+// bytes of streamed texture data uploaded per frame while async textures are loading
+const size_t TEXTURE_UPLOAD_BUDGET = 16 * 1024 * 1024;
+// bytes of texture memory the residency manager keeps resident before evicting the least recently used mips
+const size_t TEXTURE_VRAM_BUDGET = 512 * 1024 * 1024;
 
 int main(int argc, char** argv)
 {
-    GLFWwindow* window;
-    setupOpenGL(window);
+    auto startupTime = std::chrono::high_resolution_clock::now();
 
-    // Setup Dear ImGui context
-    IMGUI_CHECKVERSION();
-    ImGui::CreateContext();
-    ImGuiIO& io = ImGui::GetIO(); (void)io;
-    // io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;     // Enable Keyboard Controls
-    // io.ConfigFlags |= ImGuiConfigFlags_NavEnableGamepad;      // Enable Gamepad Controls
-    io.ConfigFlags |= ImGuiConfigFlags_DockingEnable;         // Enable Docking
-    io.ConfigFlags |= ImGuiConfigFlags_ViewportsEnable;       // Enable Multi-Viewport / Platform Windows
+    HeadlessOptions headless;
+    if (!parseHeadlessOptions(argc, argv, headless))
+        return 1;
 
-    // io.FontDefault = io.Fonts->AddFontFromFileTTF(R"(Z:\Murdoch\ICT397\UnamedEngine\Assets\font\roboto\static\Roboto-Regular.ttf))", 18.0f);
+    GLFWwindow* window;
+    if (!setupOpenGL(window, headless) && headless.enabled)
+        return 1;
 
-    // Setup Dear ImGui style
-    ImGui::StyleColorsDark();
-    // ImGui::StyleColorsLight();
+    std::string backPackPath = (R"(Assets\survival_guitar_backpack_scaled\scene.gltf)");
+    std::string sponzaPath = (R"(Assets\main1_sponza\NewSponza_Main_glTF_003.gltf)");
 
-    // When viewports are enabled we tweak WindowRounding/WindowBg so platform windows can look identical to regular ones.
-    ImGuiStyle& style = ImGui::GetStyle();
-    if (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable)
+    VertexFormat vertexFormat = VertexFormat::Full;
+    for (int i = 1; i < argc; ++i)
     {
-        style.WindowRounding = 0.0f;
-        style.Colors[ImGuiCol_WindowBg].w = 1.0f;
+        // --compact-vertices: quantize vertices to 20 bytes on upload, decoded in the vertex shaders
+        if (std::string(argv[i]) == "--compact-vertices")
+            vertexFormat = VertexFormat::Compact;
+        // --no-baked-textures: decode the source images even where TextureBake has produced a .ktx
+        if (std::string(argv[i]) == "--no-baked-textures")
+            TextureManager::getInstance().setPreferBaked(false);
+        // --mesh-optimization none|cache|overdraw: triangle/vertex reordering applied on import (default cache)
+        if (std::string(argv[i]) == "--mesh-optimization" && i + 1 < argc)
+        {
+            const std::string mode = argv[i + 1];
+            if (mode == "none")
+                ModelLoader::getInstance().setMeshOptimization(MeshOptimization::None);
+            else if (mode == "overdraw")
+                ModelLoader::getInstance().setMeshOptimization(MeshOptimization::VertexCacheAndOverdraw);
+            else if (mode == "cache")
+                ModelLoader::getInstance().setMeshOptimization(MeshOptimization::VertexCache);
+            else
+                LOG_WARNING(Import, "Unknown --mesh-optimization mode: " << mode);
+        }
+        // --bench-import [model]: compare cold (Assimp) and warm (mesh cache) startup loads, then exit
+        if (std::string(argv[i]) == "--bench-import")
+        {
+            ModelLoader::getInstance().benchmarkLoad(i + 1 < argc ? argv[i + 1] : sponzaPath);
+            glfwDestroyWindow(window);
+            glfwTerminate();
+            return 0;
+        }
+        // --bench-obj file: OBJ parse time and throughput from 1 thread up to one per hardware thread, then exit
+        if (std::string(argv[i]) == "--bench-obj" && i + 1 < argc)
+        {
+            Mesh::benchmarkImportOBJ(argv[i + 1]);
+            glfwDestroyWindow(window);
+            glfwTerminate();
+            return 0;
+        }
+        // --verify-import [model]: check the parallel importer matches the serial one, exit code reports the result
+        if (std::string(argv[i]) == "--verify-import")
+        {
+            bool identical = ModelLoader::getInstance().verifyParallelImport(i + 1 < argc ? argv[i + 1] : sponzaPath);
+            glfwDestroyWindow(window);
+            glfwTerminate();
+            return identical ? 0 : 1;
+        }
     }
 
-    // Setup Platform/Renderer backends
-    ImGui_ImplGlfw_InitForOpenGL(window, true);
-    ImGui_ImplOpenGL3_Init("#version 410");
-
     glEnable(GL_DEPTH_TEST);    //TODO why are we doing this here?
 
     // Load shaders
@@ -65,19 +148,37 @@ int main(int argc, char** argv)
     // Shader framebufferShader("framebuffer.vert","framebuffer.frag");
 
     ShaderManager shaderManager;
+    // every program (variants and hot reloads included) gets its fixed sampler units as soon as it links
+    shaderManager.setProgramInitializer(bindStaticSamplers);
+    // the vertex shaders decode whichever layout the scene's geometry arena stores
+    shaderManager.setGlobalDefines(CompactVertexPacking::shaderDefines(vertexFormat));
+    auto shaderStart = std::chrono::high_resolution_clock::now();
 
     shaderManager.loadShader("lightingShader", "new_vertex.glsl", "new_fragment.glsl");
     shaderManager.loadShader("shadowShader", "shadow_vertex.glsl", "shadow_fragment.glsl");
     shaderManager.loadShader("framebufferShader", "framebuffer.vert", "framebuffer.frag");
-
-    auto lightingShader = shaderManager.getShader("lightingShader");
-    // auto shadowShader = shaderManager.getShader("shadowShader");
-    auto framebufferShader = shaderManager.getShader("framebufferShader");
+    // batched variants used by the renderer's multi-draw-indirect path
+    if (GLEW_VERSION_4_3)
+    {
+        shaderManager.loadShader("lightingShaderIndirect", "new_vertex_indirect.glsl", "new_fragment.glsl");
+        shaderManager.loadShader("shadowShaderIndirect", "shadow_vertex_indirect.glsl", "shadow_fragment.glsl");
+    }
+    // every program above was only queued, this is where startup actually waits on the driver
+    shaderManager.finishLoading();
+    auto shaderMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - shaderStart).count();
+    LOG_INFO(Core, "Shaders ready in " << shaderMs << " ms (" << shaderManager.getBinaryCacheHits() << " of " << shaderManager.getShaderCount()
+                  << " from the binary cache, parallel compile " << (shaderManager.isParallelCompileEnabled() ? "on" : "off") << ")");
 
     Scene scene;
+    scene.setVertexFormat(vertexFormat);
+
+    // decode textures on worker threads so the first frame only waits for geometry,
+    // benchmarks load synchronously so every recorded frame sees the same textures
+    TextureManager::getInstance().setAsyncLoading(ASYNC_TEXTURES && !headless.enabled);
+    // baked textures start from a small mip and stream the rest in as they are seen, same rule as above
+    TextureManager::getInstance().getResidency().setMipStreaming(!headless.enabled);
+    TextureManager::getInstance().getResidency().setBudget(TEXTURE_VRAM_BUDGET);
 
-    std::string backPackPath = (R"(Assets\survival_guitar_backpack_scaled\scene.gltf)");
-    std::string sponzaPath = (R"(Assets\main1_sponza\NewSponza_Main_glTF_003.gltf)");
     // comment out the blow to disable loading
     // scene.loadModelToRegistry(backPackPath);
     scene.loadModelToRegistry(sponzaPath);
@@ -118,7 +219,10 @@ int main(int argc, char** argv)
     // scene.addLight(dirLight);
     // scene.addLight(pointLight);
 
-    ShadowMap shadowMap(2048.0, 2048.0);
+    // 4 cascades of 1024^2, the same memory as the single 2048^2 map this replaced
+    ShadowMap shadowMap(1024, 4);
+    // camera, light and cascade data shared by every scene program through fixed UBO bindings
+    FrameUniforms frameUniforms;
 
 
     Carbon::FrameBuffer framebuffer(windowWidth, windowHeight);
@@ -152,6 +256,52 @@ int main(int argc, char** argv)
 
 
 
+    FrameContext frame{renderer, scene, shaderManager, shadowMap, frameUniforms, framebuffer, camera, dirLight, quadVAO};
+    preloadSceneVariants(frame);
+
+    if (headless.enabled)
+    {
+        int result = runHeadlessBenchmark(frame, headless, shaderMs);
+        glfwDestroyWindow(window);
+        glfwTerminate();
+        return result;
+    }
+
+    // benchmarks must run the same programs start to finish, so only the interactive loop reloads
+    shaderManager.enableHotReload();
+    shaderManager.setReloadCallback([&renderer, &shadowMap](const std::string&, const Shader& oldShader, const Shader&) {
+        renderer.OnShaderReloaded(oldShader);
+        // cached cascades still hold depth from the old program, redrawing them once is cheap
+        shadowMap.InvalidateCache();
+    });
+
+    // Setup Dear ImGui context
+    IMGUI_CHECKVERSION();
+    ImGui::CreateContext();
+    ImGuiIO& io = ImGui::GetIO(); (void)io;
+    // io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;     // Enable Keyboard Controls
+    // io.ConfigFlags |= ImGuiConfigFlags_NavEnableGamepad;      // Enable Gamepad Controls
+    io.ConfigFlags |= ImGuiConfigFlags_DockingEnable;         // Enable Docking
+    io.ConfigFlags |= ImGuiConfigFlags_ViewportsEnable;       // Enable Multi-Viewport / Platform Windows
+
+    // io.FontDefault = io.Fonts->AddFontFromFileTTF(R"(Z:\Murdoch\ICT397\UnamedEngine\Assets\font\roboto\static\Roboto-Regular.ttf))", 18.0f);
+
+    // Setup Dear ImGui style
+    ImGui::StyleColorsDark();
+    // ImGui::StyleColorsLight();
+
+    // When viewports are enabled we tweak WindowRounding/WindowBg so platform windows can look identical to regular ones.
+    ImGuiStyle& style = ImGui::GetStyle();
+    if (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable)
+    {
+        style.WindowRounding = 0.0f;
+        style.Colors[ImGuiCol_WindowBg].w = 1.0f;
+    }
+
+    // Setup Platform/Renderer backends
+    ImGui_ImplGlfw_InitForOpenGL(window, true);
+    ImGui_ImplOpenGL3_Init("#version 410");
+
     static const int historySize = 120;
 
     glfwWindowHint(GLFW_SAMPLES, 4);
@@ -213,47 +363,38 @@ int main(int argc, char** argv)
             }
         }
 
-        // TODO fix this as it only takes in the directional light atm
-        glm::mat4 lightSpaceMatrix = shadowMap.CalculateLightSpaceMatrix(dirLight.getDirection());
-
-        renderer.ShadowPass(scene.getRegistry(), shaderManager, shadowMap, lightSpaceMatrix);
-
-        framebuffer.Bind();
-        glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); // we're not using the stencil buffer now
-        glEnable(GL_DEPTH_TEST);
-
+        Profiler& profiler = Profiler::getInstance();
+        profiler.beginFrame();
 
-        // shader and set uniforms
-        lightingShader->Bind();
-        lightingShader->SetUniformMat4f("view", camera.getViewMatrix());
-        lightingShader->SetUniformMat4f("projection", camera.getProjectionMatrix());
-        lightingShader->SetUniform3f("viewPos", camera.getPosition());
+        shaderManager.update();
 
-        // all of this lighting information should be inside the scene or something else that can be accessed in the renderer
-        lightingShader->SetUniform3f("light.direction", dirLight.getDirection());
-        lightingShader->SetUniform3f("light.ambient", dirLight.getAmbient());
-        lightingShader->SetUniform3f("light.diffuse", dirLight.getDiffuse());
-        lightingShader->SetUniform3f("light.specular", dirLight.getSpecular());
-        lightingShader->SetUniformMat4f("lightSpaceMatrix", lightSpaceMatrix);
+        beginSceneFrame(frame);
+        auto sceneCpuStart = std::chrono::high_resolution_clock::now();
 
-        glActiveTexture(GL_TEXTURE4);
-        glBindTexture(GL_TEXTURE_2D, shadowMap.GetDepthTexture());
-        lightingShader->SetUniform1i("shadowMap", 4);
-        lightingShader->SetUniform2f("gMapSize", glm::vec2(2048.0f, 2048.0f));
+        renderShadowPass(frame);
+        renderMainPass(frame);
 
-        renderer.Render(scene.getRegistry(), shaderManager, lightingShader);
+        // CPU cost of building and submitting the shadow + main passes (GPU time not included)
+        float sceneCpuMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - sceneCpuStart).count();
 
+        {
+            ProfileScope profileScope("Framebuffer blit");
+            blitFramebuffer(frame);
+        }
 
-        framebuffer.Unbind();
+        const RenderStats& stats = renderer.GetStats();
+        profiler.setCounter("Draw calls", stats.drawCalls);
+        profiler.setCounter("Triangles", stats.triangles);
+        profiler.setCounter("GL state changes", stats.stateChanges);
+        profiler.setCounter("GL state changes skipped", stats.stateChangesSkipped);
 
-        framebufferShader->Bind();
-        glBindVertexArray(quadVAO);
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, framebuffer.GetTextureColorBuffer());
-        framebufferShader->SetUniform1i("framebuf", 0);
-        glDrawArrays(GL_TRIANGLES, 0, 6);
+        const TextureResidencyStats& residency = TextureManager::getInstance().getResidency().getStats();
+        profiler.setCounter("Texture residency (MB)", residency.residentBytes / (1024.0 * 1024.0));
+        profiler.setCounter("Texture budget (MB)", residency.budgetBytes / (1024.0 * 1024.0));
+        profiler.setCounter("Mip levels streamed", residency.levelsStreamed);
+        profiler.setCounter("Mip levels evicted", residency.levelsEvicted);
 
+        profiler.beginScope("ImGui");
 
         // Start the Dear ImGui frame
         ImGui_ImplOpenGL3_NewFrame();
@@ -270,6 +411,42 @@ int main(int argc, char** argv)
             // Bottom window pane
             ImGui::Begin("Another Window");
             ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / io.Framerate, io.Framerate);
+
+            // flip this to compare the batched and per-mesh submission paths on the same scene
+            static bool useIndirect = renderer.IsUsingIndirect();
+            if (renderer.IsIndirectSupported() && ImGui::Checkbox("Multi-draw indirect", &useIndirect))
+            {
+                renderer.SetUseIndirect(useIndirect);
+            }
+            ImGui::Text("Draw calls: %u (%u meshes)", renderer.GetStats().drawCalls, renderer.GetStats().meshesSubmitted);
+            ImGui::Text("GL state changes: %u (%u redundant skipped)", renderer.GetStats().stateChanges,
+                        renderer.GetStats().stateChangesSkipped);
+            static bool useCulling = renderer.IsUsingFrustumCulling();
+            if (ImGui::Checkbox("Frustum culling", &useCulling))
+            {
+                renderer.SetUseFrustumCulling(useCulling);
+            }
+            ImGui::Text("Culled: %u of %u entities", renderer.GetStats().entitiesCulled, renderer.GetStats().entitiesTested);
+            // every level is a separate set of shader variants, build them all up front rather than stall per material
+            static int pcfLevel = static_cast<int>(renderer.GetShadowPcfLevel());
+            if (ImGui::SliderInt("Shadow PCF level", &pcfLevel, 0, static_cast<int>(ShaderFeature::kMaxPcfLevel)))
+            {
+                renderer.SetShadowPcfLevel(static_cast<unsigned int>(pcfLevel));
+                preloadSceneVariants(frame);
+            }
+            ImGui::Text("Shadow cascades redrawn: %u of %u (%u casters culled)", renderer.GetStats().shadowCascadesRendered,
+                        shadowMap.GetCascadeCount(), renderer.GetStats().shadowCastersCulled);
+            ImGui::Text("Scene submit CPU: %.3f ms", sceneCpuMs);
+            ImGui::End();
+
+            ImGui::Begin("Profiler");
+            profiler.drawImGui();
+            if (residency.budgetBytes > 0) {
+                const float used = static_cast<float>(residency.residentBytes) / static_cast<float>(residency.budgetBytes);
+                ImGui::Text("Textures: %u (%u streamable, %u at full resolution)", residency.textures,
+                            residency.streamableTextures, residency.fullResolution);
+                ImGui::ProgressBar(std::min(used, 1.0f), ImVec2(-1.0f, 0.0f), "Texture budget");
+            }
             ImGui::End();
 
 
@@ -285,11 +462,12 @@ int main(int argc, char** argv)
         // Rendering
         ImGui::Render();
         ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        profiler.endScope();
 
         GLenum error = glGetError();
         if (error != GL_NO_ERROR)
         {
-            std::cerr << "OpenGL Error: " << error << std::endl;
+            LOG_ERROR(Core, "OpenGL Error: " << error);
         }
 
 
@@ -303,8 +481,20 @@ int main(int argc, char** argv)
             ImGui::RenderPlatformWindowsDefault();
             glfwMakeContextCurrent(backup_current_context);
         }
+        profiler.endFrame();
         glfwSwapBuffers(window);
         glfwPollEvents();
+
+        static bool firstFrame = true;
+        static bool texturesReported = false;
+        if (firstFrame || (!texturesReported && !TextureManager::getInstance().hasPendingTextures()))
+        {
+            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - startupTime);
+            LOG_INFO(Core, (firstFrame ? "Time to first frame: " : "Time to all textures resident: ")
+                        << elapsed.count() << " milliseconds");
+            texturesReported = !firstFrame || !TextureManager::getInstance().hasPendingTextures();
+            firstFrame = false;
+        }
     }
 
     // Cleanup
@@ -318,25 +508,251 @@ int main(int argc, char** argv)
     return 0;
 }
 
-bool setupOpenGL(GLFWwindow*& window)
+// Sampler units that never change, a freshly linked program needs them set again
+void bindStaticSamplers(const Shader& shader)
+{
+    // the shadow map always lives on unit 4
+    shader.Bind();
+    shader.SetUniform(shader.GetUniformHandle<int>("shadowMap"), 4);
+}
+
+// Builds the scene shader variant every loaded material will ask for, in one parallel batch
+void preloadSceneVariants(FrameContext& frame)
+{
+    std::vector<std::pair<std::string, ShaderVariantKey>> variants;
+    auto view = frame.scene.getRegistry().view<MaterialComponent>();
+    for (auto entity : view)
+    {
+        const auto& material = view.get<MaterialComponent>(entity);
+        const ShaderVariantKey key = frame.renderer.GetMaterialVariant(material);
+        for (const std::string& name : {material.shaderID, material.shaderID + "Indirect"})
+        {
+            if (frame.shaderManager.hasShader(name) &&
+                std::find(variants.begin(), variants.end(), std::make_pair(name, key)) == variants.end())
+                variants.emplace_back(name, key);
+        }
+    }
+
+    for (const auto& [name, key] : variants)
+        frame.shaderManager.preloadVariant(name, key);
+    frame.shaderManager.finishLoading();
+    LOG_DEBUG(Shader, variants.size() << " scene shader variants in use, " << frame.shaderManager.getVariantCount() << " built");
+}
+
+void beginSceneFrame(FrameContext& frame)
+{
+    frame.scene.updateTextureStreaming(TEXTURE_UPLOAD_BUDGET);
+    frame.scene.updateWorldMatrices();
+
+    frame.renderer.ResetStats();
+    // pixels covered by one world unit at distance one, the renderer divides by distance for texture residency
+    const float pixelsPerUnit = static_cast<float>(frame.framebuffer.GetHeight()) * 0.5f * frame.camera.getProjectionMatrix()[1][1];
+    frame.renderer.SetCamera(frame.camera.getPosition(), frame.camera.getProjectionMatrix() * frame.camera.getViewMatrix(), pixelsPerUnit);
+
+    // TODO fix this as it only takes in the directional light atm
+    frame.shadowMap.UpdateCascades(frame.camera, frame.dirLight.getDirection());
+    frame.frameUniforms.Update(frame.camera, frame.dirLight, frame.shadowMap);
+}
+
+void renderShadowPass(FrameContext& frame)
+{
+    frame.renderer.ShadowPass(frame.scene.getRegistry(), frame.shaderManager, frame.shadowMap, frame.scene.getShadowCasterVersion());
+}
+
+void renderMainPass(FrameContext& frame)
+{
+
+    frame.framebuffer.Bind();
+    glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); // we're not using the stencil buffer now
+    glEnable(GL_DEPTH_TEST);
+
+
+    // the batched path draws with its own program, camera/light/cascade data reaches both through the frame UBOs
+    // looked up every frame (not cached) so a hot reloaded program is picked up straight away
+    auto sceneShader = frame.shaderManager.getShader(frame.renderer.IsUsingIndirect() ? "lightingShaderIndirect" : "lightingShader");
+    sceneShader->Bind();
+
+    glActiveTexture(GL_TEXTURE4);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, frame.shadowMap.GetDepthTexture());
+
+    frame.renderer.Render(frame.scene.getRegistry(), frame.shaderManager, sceneShader);
+
+    frame.framebuffer.Unbind();
+}
+
+void blitFramebuffer(FrameContext& frame)
+{
+    auto framebufferShader = frame.shaderManager.getShader("framebufferShader");
+    framebufferShader->Bind();
+    glBindVertexArray(frame.quadVAO);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, frame.framebuffer.GetTextureColorBuffer());
+    framebufferShader->SetUniform1i("framebuf", 0);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+}
+
+int runHeadlessBenchmark(FrameContext& frame, const HeadlessOptions& options, double shaderStartupMs)
+{
+    CameraPath path;
+    if (!options.cameraPathFile.empty())
+    {
+        if (!path.loadFromFile(options.cameraPathFile))
+            return 1;
+    }
+    else
+    {
+        // default fly-around, sized for Sponza
+        path = CameraPath::makeOrbit(glm::vec3(0.0f, 2.0f, 0.0f), 8.0f, 1.5f, 16);
+    }
+
+    frame.renderer.SetUseIndirect(options.useIndirect);
+
+    BenchmarkRecorder recorder;
+    recorder.setInfo("renderer", reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+    recorder.setInfo("glVersion", reinterpret_cast<const char*>(glGetString(GL_VERSION)));
+    recorder.setInfo("resolution", std::to_string(options.width) + "x" + std::to_string(options.height));
+    recorder.setInfo("cameraPath", options.cameraPathFile.empty() ? "orbit" : options.cameraPathFile);
+    recorder.setInfo("submission", frame.renderer.IsUsingIndirect() ? "indirect" : "direct");
+    // run once with the shadercache directory deleted and once with it filled to compare cold and warm startup
+    recorder.setInfo("shaderStartupMs", std::to_string(shaderStartupMs));
+    recorder.setInfo("shaderBinaryCacheHits", std::to_string(frame.shaderManager.getBinaryCacheHits()) + "/" +
+                                              std::to_string(frame.shaderManager.getShaderCount()));
+
+    const int totalFrames = options.warmupFrames + options.frames;
+    for (int i = 0; i < totalFrames; i++)
+    {
+        const bool recording = i >= options.warmupFrames;
+        // warm-up frames fly the path too, so caches see the same sequence of views
+        float t = options.frames > 1 ? static_cast<float>(std::max(i - options.warmupFrames, 0)) / static_cast<float>(options.frames - 1) : 0.0f;
+        path.apply(frame.camera, t);
+
+        if (recording)
+            recorder.beginFrame();
+
+        beginSceneFrame(frame);
+
+        if (recording) recorder.beginPass("shadow");
+        renderShadowPass(frame);
+        if (recording) recorder.endPass();
+
+        if (recording) recorder.beginPass("main");
+        renderMainPass(frame);
+        if (recording) recorder.endPass();
+
+        if (recording) recorder.beginPass("blit");
+        blitFramebuffer(frame);
+        if (recording) recorder.endPass();
+
+        if (recording)
+        {
+            const RenderStats& stats = frame.renderer.GetStats();
+            recorder.setCounter("drawCalls", stats.drawCalls);
+            recorder.setCounter("meshesSubmitted", stats.meshesSubmitted);
+            recorder.setCounter("stateChanges", stats.stateChanges);
+            recorder.setCounter("entitiesCulled", stats.entitiesCulled);
+            recorder.setCounter("shadowCascadesRendered", stats.shadowCascadesRendered);
+            recorder.endFrame();
+        }
+    }
+
+    GLenum error = glGetError();
+    if (error != GL_NO_ERROR)
+    {
+        LOG_ERROR(Core, "OpenGL Error: " << error);
+    }
+
+    return recorder.writeJson(options.outputFile) ? 0 : 1;
+}
+
+bool parseHeadlessOptions(int argc, char** argv, HeadlessOptions& options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--headless")
+            options.enabled = true;
+        else if (arg == "--gl-api" && hasValue)
+            options.useOSMesa = std::string(argv[++i]) == "osmesa";
+        else if (arg == "--size" && hasValue)
+        {
+            if (std::sscanf(argv[++i], "%dx%d", &options.width, &options.height) != 2 || options.width <= 0 || options.height <= 0)
+            {
+                LOG_ERROR(Core, "--size expects WIDTHxHEIGHT");
+                return false;
+            }
+        }
+        else if (arg == "--frames" && hasValue)
+            options.frames = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--warmup" && hasValue)
+            options.warmupFrames = std::max(0, std::atoi(argv[++i]));
+        else if (arg == "--camera-path" && hasValue)
+            options.cameraPathFile = argv[++i];
+        else if (arg == "--output" && hasValue)
+            options.outputFile = argv[++i];
+        else if (arg == "--no-indirect")
+            options.useIndirect = false;
+    }
+    return true;
+}
+
+bool setupOpenGL(GLFWwindow*& window, const HeadlessOptions& headless)
 {
     bool OpenGLSuccess = true;
 
+#ifdef GLFW_PLATFORM_NULL
+    // GLFW 3.4+: no display server at all, the context comes from OSMesa or surfaceless EGL
+    if (headless.enabled)
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+    const bool headlessNeedsDisplay = false;
+#else
+    // older GLFW has no null platform, glfwInit still connects to X11/Wayland even for a hidden window
+    const bool headlessNeedsDisplay = true;
+    if (headless.enabled)
+        LOG_WARNING(Core, "--headless: GLFW " << GLFW_VERSION_MAJOR << "." << GLFW_VERSION_MINOR
+                    << " has no null platform (3.4+), a display server is still required");
+#endif
     if (!glfwInit())
     {
-        std::cerr << "glfwInit(): GLFW failed to initialize" << std::endl;
+        LOG_ERROR(Core, "glfwInit(): GLFW failed to initialize");
+        if (headless.enabled)
+        {
+            if (headlessNeedsDisplay)
+                LOG_ERROR(Core, "--headless without a display server needs GLFW 3.4 or newer, or run under Xvfb");
+            return false;
+        }
         OpenGLSuccess = false;
     }
+    // ask for 4.3 so the renderer can use multi-draw-indirect, drop back to 4.1 (e.g. macOS) if that fails
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 
-    window = glfwCreateWindow(1920*2, 1080*2, "Carbon Renderer", glfwGetPrimaryMonitor(), nullptr);
+    // headless runs render into a hidden window whose context is software (OSMesa/llvmpipe) or EGL,
+    // the scene itself always goes through the offscreen framebuffer
+    int windowWidth = 1920*2, windowHeight = 1080*2;
+    GLFWmonitor* monitor = glfwGetPrimaryMonitor();
+    if (headless.enabled)
+    {
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, headless.useOSMesa ? GLFW_OSMESA_CONTEXT_API : GLFW_EGL_CONTEXT_API);
+        windowWidth = headless.width;
+        windowHeight = headless.height;
+        monitor = nullptr;
+    }
+
+    window = glfwCreateWindow(windowWidth, windowHeight, "Carbon Renderer", monitor, nullptr);
     if (!window)
     {
-        std::cerr << "glfwCreateWindow(): Failed to create GLFW window" << std::endl;
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
+        window = glfwCreateWindow(windowWidth, windowHeight, "Carbon Renderer", monitor, nullptr);
+    }
+    if (!window)
+    {
+        LOG_ERROR(Core, "glfwCreateWindow(): Failed to create GLFW window");
         glfwTerminate();
-        OpenGLSuccess = false;
+        return false;
     }
 
     glfwMakeContextCurrent(window);
@@ -345,17 +761,22 @@ bool setupOpenGL(GLFWwindow*& window)
 
     glewExperimental = GL_TRUE;
     GLenum err = glewInit();
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+    // a GLX build of GLEW still loads the core GL entry points for an EGL/OSMesa context, it just can't find GLX
+    if (headless.enabled && err == GLEW_ERROR_NO_GLX_DISPLAY)
+        err = GLEW_OK;
+#endif
     if (GLEW_OK != err)
     {
-        std::cerr << "glewInit(): GLEW failed to initialize" << std::endl;
+        LOG_ERROR(Core, "glewInit(): GLEW failed to initialize");
         OpenGLSuccess = false;
     }
 
-    std::cout << "OpenGL Version: " << glGetString(GL_VERSION) << std::endl;
-    std::cout << "GLSL Version: " << glGetString(GL_SHADING_LANGUAGE_VERSION) << std::endl;
+    LOG_INFO(Core, "OpenGL Version: " << glGetString(GL_VERSION));
+    LOG_INFO(Core, "GLSL Version: " << glGetString(GL_SHADING_LANGUAGE_VERSION));
     if (glfwGetWindowAttrib(window, GLFW_OPENGL_PROFILE) != GLFW_OPENGL_CORE_PROFILE)
     {
-        std::cerr << "Failed to create OpenGL core profile context!" << std::endl;
+        LOG_ERROR(Core, "Failed to create OpenGL core profile context!");
         return false;
     }
 